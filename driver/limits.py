@@ -48,13 +48,21 @@ def set_time_limit(time_limit):
         resource.setrlimit(resource.RLIMIT_CPU, (time_limit, time_limit))
 
 
-def set_memory_limit(memory):
-    """*memory* must be given in bytes or None."""
+def set_memory_limit(memory, count_shared_mappings=True):
+    """*memory* must be given in bytes or None.
+
+    If *count_shared_mappings* is False, we limit the data segment instead
+    of the address space. The data segment includes the heap and all
+    private mappings, but not shared file mappings such as the external
+    memory of the search component (see --external-memory)."""
     if memory is None:
         return
     if not can_set_memory_limit():
         raise NotImplementedError(CANNOT_LIMIT_MEMORY_MSG)
-    resource.setrlimit(resource.RLIMIT_AS, (memory, memory))
+    if count_shared_mappings:
+        resource.setrlimit(resource.RLIMIT_AS, (memory, memory))
+    else:
+        resource.setrlimit(resource.RLIMIT_DATA, (memory, memory))
 
 
 def convert_to_mb(num_bytes):
@@ -126,13 +126,17 @@ def run_search(args):
                 "search needs --alias, --portfolio, or search options")
         if "--help" not in args.search_options:
             args.search_options.extend(["--internal-plan-file", args.plan_file])
+        # External memory is mapped from a file and must not count
+        # towards the memory limit.
+        uses_external_memory = "--external-memory" in args.search_options
         try:
             call.check_call(
                 "search",
                 [executable] + args.search_options,
                 stdin=args.search_input,
                 time_limit=time_limit,
-                memory_limit=memory_limit)
+                memory_limit=memory_limit,
+                count_shared_mappings=not uses_external_memory)
         except subprocess.CalledProcessError as err:
             # TODO: if we ever add support for SEARCH_PLAN_FOUND_AND_* directly
             # in the planner, this assertion no longer holds. Furthermore, we
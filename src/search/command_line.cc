@@ -8,6 +8,9 @@
 #include "plugins/any.h"
 #include "plugins/doc_printer.h"
 #include "plugins/plugin.h"
+#include "utils/external_memory.h"
+#include "utils/parallel.h"
+#include "utils/persistent_cache.h"
 #include "utils/logging.h"
 #include "utils/strings.h"
 
@@ -34,6 +37,66 @@ static int parse_int_arg(const string &name, const string &value) {
     }
 }
 
+/*
+  External memory, the persistent cache and the preprocessing threads have
+  to be set up before the search algorithm (and with it the state registry
+  and the heuristics) is constructed, so we handle these options before all
+  others, independently of their position.
+*/
+static void parse_storage_options(const vector<string> &args) {
+    string directory;
+    string cache_directory;
+    int resident_memory_in_mb = 1024;
+    int num_preprocessing_threads = 1;
+    int preprocessing_memory_in_mb = 2048;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const string &arg = args[i];
+        bool is_last = (i == args.size() - 1);
+        if (arg == "--external-memory") {
+            if (is_last)
+                input_error("missing argument after --external-memory");
+            ++i;
+            directory = args[i];
+        } else if (arg == "--external-memory-resident-mb") {
+            if (is_last)
+                input_error("missing argument after --external-memory-resident-mb");
+            ++i;
+            resident_memory_in_mb = parse_int_arg(arg, args[i]);
+            if (resident_memory_in_mb < 1)
+                input_error("argument for --external-memory-resident-mb must be positive");
+        } else if (arg == "--preprocessing-cache") {
+            if (is_last)
+                input_error("missing argument after --preprocessing-cache");
+            ++i;
+            cache_directory = args[i];
+        } else if (arg == "--preprocessing-threads") {
+            if (is_last)
+                input_error("missing argument after --preprocessing-threads");
+            ++i;
+            num_preprocessing_threads = parse_int_arg(arg, args[i]);
+            if (num_preprocessing_threads < 1)
+                input_error("argument for --preprocessing-threads must be positive");
+        } else if (arg == "--preprocessing-memory-mb") {
+            if (is_last)
+                input_error("missing argument after --preprocessing-memory-mb");
+            ++i;
+            preprocessing_memory_in_mb = parse_int_arg(arg, args[i]);
+            if (preprocessing_memory_in_mb < 1)
+                input_error("argument for --preprocessing-memory-mb must be positive");
+        } else if (arg == "--search") {
+            // Skip the search argument.
+            ++i;
+        }
+    }
+    if (!directory.empty())
+        utils::enable_external_memory(directory, resident_memory_in_mb);
+    if (!cache_directory.empty())
+        utils::enable_persistent_cache(cache_directory);
+    utils::set_preprocessing_threads(num_preprocessing_threads);
+    utils::set_preprocessing_memory_budget(
+        static_cast<size_t>(preprocessing_memory_in_mb) * 1024 * 1024);
+}
+
 static vector<string> replace_old_style_predefinitions(const vector<string> &args) {
     vector<string> new_args;
     int num_predefinitions = 0;
@@ -85,6 +148,8 @@ static shared_ptr<SearchAlgorithm> parse_cmd_line_aux(const vector<string> &args
     int num_previously_generated_plans = 0;
     bool is_part_of_anytime_portfolio = false;
 
+    parse_storage_options(args);
+
     using SearchPtr = shared_ptr<SearchAlgorithm>;
     SearchPtr search_algorithm = nullptr;
     // TODO: Remove code duplication.
@@ -151,6 +216,13 @@ static shared_ptr<SearchAlgorithm> parse_cmd_line_aux(const vector<string> &args
             num_previously_generated_plans = parse_int_arg(arg, args[i]);
             if (num_previously_generated_plans < 0)
                 input_error("argument for --internal-previous-portfolio-plans must be positive");
+        } else if (arg == "--external-memory" ||
+                   arg == "--external-memory-resident-mb" ||
+                   arg == "--preprocessing-cache" ||
+                   arg == "--preprocessing-threads" ||
+                   arg == "--preprocessing-memory-mb") {
+            // Already handled by parse_storage_options.
+            ++i;
         } else {
             input_error("unknown option " + arg);
         }
@@ -202,5 +274,28 @@ string usage(const string &progname) {
            "    This planner call is part of a portfolio which already created\n"
            "    plan files FILENAME.1 up to FILENAME.COUNTER.\n"
            "    Start enumerating plan files with COUNTER+1, i.e. FILENAME.COUNTER+1\n\n"
+           "--external-memory DIRECTORY\n"
+           "    Store registered states and per-state information in a file in\n"
+           "    DIRECTORY. Only recently allocated data is kept in memory, the\n"
+           "    rest is written to disk and read back when accessed. The file\n"
+           "    counts towards address space limits, so the driver limits the\n"
+           "    data segment (RLIMIT_DATA) instead when this option is used.\n"
+           "--external-memory-resident-mb MEGABYTES\n"
+           "    Amount of recently allocated per-state data that is kept in memory\n"
+           "    for each state registry when using --external-memory (default: 1024)\n\n"
+           "--preprocessing-cache DIRECTORY\n"
+           "    Store the distance tables of the pattern databases that end up in\n"
+           "    the heuristic (pdb, cpdbs, zopdbs, and the initial patterns of ipdb)\n"
+           "    in DIRECTORY and reuse them in later runs on the same task.\n"
+           "    Pattern generation still runs in full, including the PDBs it builds\n"
+           "    internally, such as the candidates of ipdb's hill climbing, which\n"
+           "    are never cached. Merge-and-shrink abstractions, Cartesian\n"
+           "    abstractions and landmark graphs are not cached either.\n\n"
+           "--preprocessing-threads NUM\n"
+           "    Compute the pattern databases of a pattern collection on NUM\n"
+           "    threads (default: 1).\n"
+           "--preprocessing-memory-mb MEGABYTES\n"
+           "    Memory that the pattern databases computed in parallel may use\n"
+           "    together while they are being built (default: 2048)\n\n"
            "See https://www.fast-downward.org for details.";
 }
@@ -0,0 +1,199 @@
+#include "concurrent_state_registry.h"
+
+#include "task_utils/task_properties.h"
+#include "utils/hash.h"
+#include "utils/logging.h"
+#include "utils/memory.h"
+#include "utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+using namespace std;
+
+ConcurrentStateRegistry::HashTable::HashTable(int capacity)
+    : capacity(capacity),
+      slots(new atomic<int>[capacity]) {
+    for (int i = 0; i < capacity; ++i) {
+        slots[i].store(EMPTY_SLOT, memory_order_relaxed);
+    }
+}
+
+ConcurrentStateRegistry::Shard::Shard()
+    : num_states(0),
+      segments(new atomic<PackedStateBin *>[MAX_SEGMENTS_PER_SHARD]),
+      table(nullptr) {
+    for (int i = 0; i < MAX_SEGMENTS_PER_SHARD; ++i) {
+        segments[i].store(nullptr, memory_order_relaxed);
+    }
+    tables.push_back(utils::make_unique_ptr<HashTable>(1024));
+    table.store(tables.back().get(), memory_order_release);
+}
+
+ConcurrentStateRegistry::Shard::~Shard() {
+    for (int i = 0; i < MAX_SEGMENTS_PER_SHARD; ++i) {
+        delete[] segments[i].load(memory_order_relaxed);
+    }
+}
+
+ConcurrentStateRegistry::ConcurrentStateRegistry(
+    const TaskProxy &task_proxy, int num_shards)
+    : task_proxy(task_proxy),
+      state_packer(task_properties::g_state_packers[task_proxy]),
+      num_bins(state_packer.get_num_bins()),
+      shard_bits(0) {
+    assert(num_shards >= 1);
+    while ((1 << shard_bits) < num_shards) {
+        ++shard_bits;
+    }
+    shards.reserve(1 << shard_bits);
+    for (int i = 0; i < (1 << shard_bits); ++i) {
+        shards.push_back(utils::make_unique_ptr<Shard>());
+    }
+}
+
+ConcurrentStateRegistry::~ConcurrentStateRegistry() {
+}
+
+uint64_t ConcurrentStateRegistry::get_hash(const PackedStateBin *buffer) const {
+    utils::HashState hash_state;
+    for (int i = 0; i < num_bins; ++i) {
+        hash_state.feed(buffer[i]);
+    }
+    return hash_state.get_hash64();
+}
+
+int ConcurrentStateRegistry::get_shard_index(uint64_t hash) const {
+    if (shard_bits == 0)
+        return 0;
+    return static_cast<int>(hash >> (64 - shard_bits));
+}
+
+StateID ConcurrentStateRegistry::get_global_id(
+    int shard_index, int local_id) const {
+    return StateID((local_id << shard_bits) | shard_index);
+}
+
+const PackedStateBin *ConcurrentStateRegistry::get_buffer(
+    const Shard &shard, int local_id) const {
+    const PackedStateBin *segment =
+        shard.segments[local_id >> SEGMENT_BITS].load(memory_order_acquire);
+    assert(segment);
+    return segment + (local_id & (STATES_PER_SEGMENT - 1)) * num_bins;
+}
+
+int ConcurrentStateRegistry::find_in_shard(
+    const Shard &shard, const PackedStateBin *buffer, uint64_t hash) const {
+    const HashTable *table = shard.table.load(memory_order_acquire);
+    int mask = table->capacity - 1;
+    for (int pos = hash & mask;; pos = (pos + 1) & mask) {
+        int local_id = table->slots[pos].load(memory_order_acquire);
+        if (local_id == EMPTY_SLOT)
+            return EMPTY_SLOT;
+        const PackedStateBin *data = get_buffer(shard, local_id);
+        if (equal(data, data + num_bins, buffer))
+            return local_id;
+    }
+}
+
+void ConcurrentStateRegistry::insert_into_table(
+    HashTable &table, int local_id, uint64_t hash) const {
+    int mask = table.capacity - 1;
+    int pos = hash & mask;
+    while (table.slots[pos].load(memory_order_relaxed) != EMPTY_SLOT) {
+        pos = (pos + 1) & mask;
+    }
+    table.slots[pos].store(local_id, memory_order_release);
+}
+
+void ConcurrentStateRegistry::grow_table(Shard &shard) const {
+    const HashTable *old_table = shard.table.load(memory_order_relaxed);
+    unique_ptr<HashTable> new_table =
+        utils::make_unique_ptr<HashTable>(2 * old_table->capacity);
+    int num_states = shard.num_states.load(memory_order_relaxed);
+    for (int local_id = 0; local_id < num_states; ++local_id) {
+        insert_into_table(
+            *new_table, local_id, get_hash(get_buffer(shard, local_id)));
+    }
+    shard.table.store(new_table.get(), memory_order_release);
+    shard.tables.push_back(move(new_table));
+}
+
+pair<StateID, bool> ConcurrentStateRegistry::insert(
+    const PackedStateBin *buffer) {
+    uint64_t hash = get_hash(buffer);
+    int shard_index = get_shard_index(hash);
+    Shard &shard = *shards[shard_index];
+
+    int local_id = find_in_shard(shard, buffer, hash);
+    if (local_id != EMPTY_SLOT)
+        return make_pair(get_global_id(shard_index, local_id), false);
+
+    lock_guard<mutex> lock(shard.insertion_mutex);
+    // Another thread may have registered the state in the meantime.
+    local_id = find_in_shard(shard, buffer, hash);
+    if (local_id != EMPTY_SLOT)
+        return make_pair(get_global_id(shard_index, local_id), false);
+
+    local_id = shard.num_states.load(memory_order_relaxed);
+    int segment_index = local_id >> SEGMENT_BITS;
+    if (segment_index >= MAX_SEGMENTS_PER_SHARD ||
+        local_id >= (numeric_limits<int>::max() >> shard_bits)) {
+        cerr << "Concurrent state registry is full." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    PackedStateBin *segment =
+        shard.segments[segment_index].load(memory_order_relaxed);
+    if (!segment) {
+        segment = new PackedStateBin[STATES_PER_SEGMENT * num_bins];
+        shard.segments[segment_index].store(segment, memory_order_release);
+    }
+    copy_n(buffer, num_bins,
+           segment + (local_id & (STATES_PER_SEGMENT - 1)) * num_bins);
+    shard.num_states.store(local_id + 1, memory_order_release);
+
+    // Keep the load factor of the table at most 1/2.
+    if (2 * (local_id + 1) > shard.table.load(memory_order_relaxed)->capacity) {
+        grow_table(shard);
+    } else {
+        insert_into_table(
+            *shard.table.load(memory_order_relaxed), local_id, hash);
+    }
+    return make_pair(get_global_id(shard_index, local_id), true);
+}
+
+StateID ConcurrentStateRegistry::find(const PackedStateBin *buffer) const {
+    uint64_t hash = get_hash(buffer);
+    int shard_index = get_shard_index(hash);
+    int local_id = find_in_shard(*shards[shard_index], buffer, hash);
+    if (local_id == EMPTY_SLOT)
+        return StateID::no_state;
+    return get_global_id(shard_index, local_id);
+}
+
+const PackedStateBin *ConcurrentStateRegistry::lookup_buffer(StateID id) const {
+    return get_buffer(*shards[get_shard(id)], get_index_in_shard(id));
+}
+
+size_t ConcurrentStateRegistry::size() const {
+    size_t num_states = 0;
+    for (const unique_ptr<Shard> &shard : shards) {
+        num_states += shard->num_states.load(memory_order_acquire);
+    }
+    return num_states;
+}
+
+void ConcurrentStateRegistry::print_statistics(utils::LogProxy &log) const {
+    log << "Number of registered states: " << size() << endl;
+    size_t min_shard_size = numeric_limits<size_t>::max();
+    size_t max_shard_size = 0;
+    for (const unique_ptr<Shard> &shard : shards) {
+        size_t shard_size = shard->num_states.load(memory_order_acquire);
+        min_shard_size = min(min_shard_size, shard_size);
+        max_shard_size = max(max_shard_size, shard_size);
+    }
+    log << "Number of registry shards: " << shards.size() << endl;
+    log << "Registry shard sizes: " << min_shard_size << " to "
+        << max_shard_size << endl;
+}
@@ -0,0 +1,145 @@
+#ifndef CONCURRENT_STATE_REGISTRY_H
+#define CONCURRENT_STATE_REGISTRY_H
+
+#include "state_id.h"
+#include "state_registry.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace utils {
+class LogProxy;
+}
+
+/*
+  ConcurrentStateRegistry stores packed states like StateRegistry, but can
+  be shared by several threads. (For documentation on registered states
+  see the file state_registry.h.)
+
+  The registry is split into shards that are selected by the high bits of
+  a state's hash. Each shard has its own hash table and append-only
+  segmented storage. Inserting a new state locks its shard. Looking up
+  states, both by ID and by content, needs no locks: state data and
+  segments are written before they are published with release stores,
+  and hash tables are replaced (not modified) when they grow. Replaced
+  tables stay alive until the registry is destroyed, so concurrent
+  readers never see freed memory.
+
+  A StateID encodes the shard of the state in its low bits. IDs are
+  therefore unique across the registry and stay dense if the shards
+  grow evenly.
+
+  The registry does not create State objects because these refer to a
+  StateRegistry. Users work with the packed data directly, using the
+  registry's state packer.
+*/
+class ConcurrentStateRegistry {
+    static const int SEGMENT_BITS = 14;
+    static const int STATES_PER_SEGMENT = 1 << SEGMENT_BITS;
+    static const int MAX_SEGMENTS_PER_SHARD = 1 << 14;
+    static const int EMPTY_SLOT = -1;
+
+    struct HashTable {
+        int capacity;
+        std::unique_ptr<std::atomic<int>[]> slots;
+
+        explicit HashTable(int capacity);
+    };
+
+    struct Shard {
+        std::mutex insertion_mutex;
+        std::atomic<int> num_states;
+        std::unique_ptr<std::atomic<PackedStateBin *>[]> segments;
+        std::atomic<HashTable *> table;
+        // Owns the current table and all tables it replaced.
+        std::vector<std::unique_ptr<HashTable>> tables;
+
+        Shard();
+        ~Shard();
+    };
+
+    TaskProxy task_proxy;
+    const int_packer::IntPacker &state_packer;
+    const int num_bins;
+    int shard_bits;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    std::uint64_t get_hash(const PackedStateBin *buffer) const;
+    int get_shard_index(std::uint64_t hash) const;
+    StateID get_global_id(int shard_index, int local_id) const;
+    const PackedStateBin *get_buffer(const Shard &shard, int local_id) const;
+    int find_in_shard(const Shard &shard, const PackedStateBin *buffer,
+                      std::uint64_t hash) const;
+    void insert_into_table(HashTable &table, int local_id,
+                           std::uint64_t hash) const;
+    void grow_table(Shard &shard) const;
+public:
+    /*
+      The number of shards is rounded up to the next power of two. Using
+      (a small multiple of) the number of threads keeps lock contention low.
+    */
+    ConcurrentStateRegistry(const TaskProxy &task_proxy, int num_shards);
+    ~ConcurrentStateRegistry();
+
+    const TaskProxy &get_task_proxy() const {
+        return task_proxy;
+    }
+
+    const int_packer::IntPacker &get_state_packer() const {
+        return state_packer;
+    }
+
+    int get_num_bins() const {
+        return num_bins;
+    }
+
+    int get_num_shards() const {
+        return shards.size();
+    }
+
+    // Returns the shard that stores the state with the given ID.
+    int get_shard(StateID id) const {
+        return id.value & ((1 << shard_bits) - 1);
+    }
+
+    /*
+      Returns the position of the state with the given ID in its shard.
+      Positions are dense within each shard, so users can store per-state
+      data in one vector per shard.
+    */
+    int get_index_in_shard(StateID id) const {
+        return id.value >> shard_bits;
+    }
+
+    /*
+      Registers the packed state if this was not done before. Returns its
+      ID and whether it was newly registered. Thread-safe.
+    */
+    std::pair<StateID, bool> insert(const PackedStateBin *buffer);
+
+    /*
+      Returns the ID of the packed state or StateID::no_state if it is not
+      registered. Lock-free.
+    */
+    StateID find(const PackedStateBin *buffer) const;
+
+    /*
+      Returns the packed data of the state with the given ID, which must
+      have been returned by this registry. Lock-free.
+    */
+    const PackedStateBin *lookup_buffer(StateID id) const;
+
+    /*
+      Returns the number of registered states. Only exact if no insertions
+      happen concurrently.
+    */
+    size_t size() const;
+
+    void print_statistics(utils::LogProxy &log) const;
+};
+
+#endif
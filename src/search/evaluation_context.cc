@@ -55,6 +55,22 @@ const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     return result;
 }
 
+bool EvaluationContext::has_result(Evaluator *evaluator) const {
+    return cache.contains(evaluator);
+}
+
+void EvaluationContext::store_result(
+    Evaluator *evaluator, EvaluationResult &&result) {
+    EvaluationResult &cached_result = cache[evaluator];
+    assert(cached_result.is_uninitialized());
+    cached_result = move(result);
+    if (statistics &&
+        evaluator->is_used_for_counting_evaluations() &&
+        cached_result.get_count_evaluation()) {
+        statistics->inc_evaluations();
+    }
+}
+
 const EvaluatorCache &EvaluationContext::get_cache() const {
     return cache;
 }
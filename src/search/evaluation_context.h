@@ -90,6 +90,13 @@ public:
         SearchStatistics *statistics = nullptr, bool calculate_preferred = false);
 
     const EvaluationResult &get_result(Evaluator *eval);
+    bool has_result(Evaluator *eval) const;
+    /*
+      Store a result that was computed outside of get_result, e.g. by
+      batch evaluation (see Evaluator::compute_batch_results). There
+      must not be a result for the evaluator yet.
+    */
+    void store_result(Evaluator *eval, EvaluationResult &&result);
     const EvaluatorCache &get_cache() const;
     const State &get_state() const;
     int get_g_value() const;
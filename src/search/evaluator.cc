@@ -1,5 +1,7 @@
 #include "evaluator.h"
 
+#include "evaluation_context.h"
+
 #include "plugins/plugin.h"
 #include "utils/logging.h"
 #include "utils/system.h"
@@ -50,6 +52,12 @@ const string &Evaluator::get_description() const {
     return description;
 }
 
+void Evaluator::compute_batch_results(
+    const vector<EvaluationContext *> &eval_contexts) {
+    for (EvaluationContext *eval_context : eval_contexts)
+        eval_context->get_result(this);
+}
+
 bool Evaluator::is_used_for_reporting_minima() const {
     return use_for_reporting_minima;
 }
@@ -6,6 +6,7 @@
 #include "utils/logging.h"
 
 #include <set>
+#include <vector>
 
 class EvaluationContext;
 class State;
@@ -82,6 +83,17 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) = 0;
 
+    /*
+      compute_batch_results should make sure that all given evaluation
+      contexts hold a result for this evaluator. Evaluators that can
+      share work between several states (e.g., all successors of an
+      expanded state) can override it and store their results with
+      EvaluationContext::store_result. The default implementation
+      evaluates the contexts one after the other.
+    */
+    virtual void compute_batch_results(
+        const std::vector<EvaluationContext *> &eval_contexts);
+
     void report_value_for_initial_state(const EvaluationResult &result) const;
     void report_new_minimum_value(const EvaluationResult &result) const;
 
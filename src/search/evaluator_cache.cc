@@ -6,3 +6,8 @@ using namespace std;
 EvaluationResult &EvaluatorCache::operator[](Evaluator *eval) {
     return eval_results[eval];
 }
+
+bool EvaluatorCache::contains(Evaluator *eval) const {
+    auto it = eval_results.find(eval);
+    return it != eval_results.end() && !it->second.is_uninitialized();
+}
@@ -46,6 +46,14 @@ EvaluationResult CombiningEvaluator::compute_result(
     return result;
 }
 
+void CombiningEvaluator::compute_batch_results(
+    const vector<EvaluationContext *> &eval_contexts) {
+    // Let the subevaluators share work between the states of the batch.
+    for (const shared_ptr<Evaluator> &subevaluator : subevaluators)
+        subevaluator->compute_batch_results(eval_contexts);
+    Evaluator::compute_batch_results(eval_contexts);
+}
+
 void CombiningEvaluator::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
     for (auto &subevaluator : subevaluators)
@@ -39,6 +39,8 @@ public:
     virtual bool dead_ends_are_reliable() const override;
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual void compute_batch_results(
+        const std::vector<EvaluationContext *> &eval_contexts) override;
 
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) override;
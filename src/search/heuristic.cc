@@ -8,6 +8,7 @@
 #include "tasks/cost_adapted_task.h"
 #include "tasks/root_task.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <limits>
@@ -19,12 +20,39 @@ Heuristic::Heuristic(
     utils::Verbosity verbosity)
     : Evaluator(true, true, true, description, verbosity),
       heuristic_cache(HEntry(NO_VALUE, true)), //TODO: is true really a good idea here?
+      wide_heuristic_cache(WideHEntry(NO_VALUE, true)),
+      use_wide_entries(false),
+      preferred_operator_record_ids(-1),
+      cache_preferred_operators(false),
+      num_dead_preferred_operators(0),
       cache_evaluator_values(cache_estimates),
       task(transform),
       task_proxy(*task) {
 }
 
 Heuristic::~Heuristic() {
+    if (cache_preferred_operators && log.is_at_least_normal()) {
+        int num_states = preferred_operator_records.size() -
+            free_preferred_operator_record_ids.size();
+        int num_operators =
+            cached_preferred_operators.size() - num_dead_preferred_operators;
+        size_t num_live_bytes =
+            num_states * sizeof(PreferredOperatorRecord) +
+            num_operators * sizeof(OperatorID);
+        size_t num_dead_bytes =
+            free_preferred_operator_record_ids.size() *
+            sizeof(PreferredOperatorRecord) +
+            (cached_preferred_operators.capacity() - num_operators) *
+            sizeof(OperatorID);
+        double bytes_per_state = num_states
+            ? static_cast<double>(num_live_bytes) / num_states
+            : 0.0;
+        log << "Cached preferred operators of " << get_description() << ": "
+            << num_operators << " operators for " << num_states
+            << " states, " << num_live_bytes << " live bytes ("
+            << bytes_per_state << " bytes per state), "
+            << num_dead_bytes << " dead bytes" << endl;
+    }
 }
 
 void Heuristic::set_preferred(const OperatorProxy &op) {
@@ -56,6 +84,120 @@ get_heuristic_arguments_from_options(const plugins::Options &opts) {
         get_evaluator_arguments_from_options(opts));
 }
 
+int Heuristic::get_cached_value(const State &state) const {
+    if (use_wide_entries) {
+        const WideHEntry &entry = wide_heuristic_cache[state];
+        if (entry.h != NO_VALUE)
+            return entry.h;
+    }
+    return heuristic_cache[state].get_h();
+}
+
+bool Heuristic::has_clean_cached_value(const State &state) const {
+    if (use_wide_entries) {
+        const WideHEntry &entry = wide_heuristic_cache[state];
+        if (entry.h != NO_VALUE)
+            return !entry.dirty;
+    }
+    HEntry entry = heuristic_cache[state];
+    return entry.get_h() != NO_VALUE && !entry.dirty;
+}
+
+void Heuristic::set_cached_value(const State &state, int h) {
+    assert(h == DEAD_END || h >= 0);
+    if (!use_wide_entries && h - NO_VALUE < (1 << 15)) {
+        heuristic_cache[state] = HEntry(h, false);
+    } else {
+        use_wide_entries = true;
+        wide_heuristic_cache[state] = WideHEntry(h, false);
+    }
+}
+
+void Heuristic::mark_cached_value_dirty(const State &state) {
+    if (use_wide_entries) {
+        WideHEntry &entry = wide_heuristic_cache[state];
+        if (entry.h == NO_VALUE) {
+            // Move a value cached before the switch to the wide entry.
+            const auto &narrow_cache = heuristic_cache;
+            entry.h = narrow_cache[state].get_h();
+        }
+        entry.dirty = true;
+    } else {
+        heuristic_cache[state].dirty = true;
+    }
+}
+
+bool Heuristic::has_cached_preferred_operators(const State &state) const {
+    return preferred_operator_record_ids[state] != -1;
+}
+
+void Heuristic::cache_preferred_operators_of(
+    const State &state, bool dead_end) {
+    int size = dead_end ? 0 : preferred_operators.size();
+    int &record_id = preferred_operator_record_ids[state];
+    if (record_id == -1) {
+        if (free_preferred_operator_record_ids.empty()) {
+            record_id = preferred_operator_records.size();
+            preferred_operator_records.emplace_back(-1, 0);
+        } else {
+            record_id = free_preferred_operator_record_ids.back();
+            free_preferred_operator_record_ids.pop_back();
+        }
+    }
+    PreferredOperatorRecord &record = preferred_operator_records[record_id];
+    if (record.begin != -1 && size <= record.size) {
+        // Overwrite the previous operators of the state.
+        num_dead_preferred_operators += record.size - size;
+        if (size) {
+            copy(preferred_operators.begin(), preferred_operators.end(),
+                 cached_preferred_operators.begin() + record.begin);
+        }
+    } else {
+        if (record.begin != -1)
+            num_dead_preferred_operators += record.size;
+        record.begin = cached_preferred_operators.size();
+        if (size) {
+            cached_preferred_operators.insert(
+                cached_preferred_operators.end(),
+                preferred_operators.begin(), preferred_operators.end());
+        }
+    }
+    record.size = size;
+    if (2 * num_dead_preferred_operators >
+        static_cast<int>(cached_preferred_operators.size()))
+        compact_cached_preferred_operators();
+}
+
+void Heuristic::release_preferred_operators_of(const State &state) {
+    int &record_id = preferred_operator_record_ids[state];
+    assert(record_id != -1);
+    PreferredOperatorRecord &record = preferred_operator_records[record_id];
+    num_dead_preferred_operators += record.size;
+    record.begin = -1;
+    record.size = 0;
+    free_preferred_operator_record_ids.push_back(record_id);
+    record_id = -1;
+    if (2 * num_dead_preferred_operators >
+        static_cast<int>(cached_preferred_operators.size()))
+        compact_cached_preferred_operators();
+}
+
+void Heuristic::compact_cached_preferred_operators() {
+    vector<OperatorID> live_operators;
+    live_operators.reserve(
+        cached_preferred_operators.size() - num_dead_preferred_operators);
+    for (PreferredOperatorRecord &record : preferred_operator_records) {
+        if (record.begin == -1)
+            continue;
+        auto begin = cached_preferred_operators.begin() + record.begin;
+        record.begin = live_operators.size();
+        live_operators.insert(
+            live_operators.end(), begin, begin + record.size);
+    }
+    cached_preferred_operators.swap(live_operators);
+    num_dead_preferred_operators = 0;
+}
+
 EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     EvaluationResult result;
 
@@ -63,17 +205,31 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
 
     const State &state = eval_context.get_state();
     bool calculate_preferred = eval_context.get_calculate_preferred();
+    // Estimates are cached per registered state.
+    bool use_cache = cache_evaluator_values && state.get_registry();
+    if (calculate_preferred && use_cache)
+        cache_preferred_operators = true;
 
     int heuristic = NO_VALUE;
 
-    if (!calculate_preferred && cache_evaluator_values &&
-        heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
-        heuristic = heuristic_cache[state].h;
+    if (use_cache && has_clean_cached_value(state) &&
+        (!calculate_preferred || has_cached_preferred_operators(state))) {
+        heuristic = get_cached_value(state);
+        if (calculate_preferred) {
+            const PreferredOperatorRecord &record =
+                preferred_operator_records[preferred_operator_record_ids[state]];
+            for (int i = 0; i < record.size; ++i) {
+                preferred_operators.insert(
+                    cached_preferred_operators[record.begin + i]);
+            }
+        }
         result.set_count_evaluation(false);
     } else {
         heuristic = compute_heuristic(state);
-        if (cache_evaluator_values) {
-            heuristic_cache[state] = HEntry(heuristic, false);
+        if (use_cache) {
+            set_cached_value(state, heuristic);
+            if (cache_preferred_operators)
+                cache_preferred_operators_of(state, heuristic == DEAD_END);
         }
         result.set_count_evaluation(true);
     }
@@ -108,15 +264,70 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     return result;
 }
 
+void Heuristic::compute_heuristic_batch(
+    const vector<State> &ancestor_states, vector<int> &values) {
+    values.clear();
+    values.reserve(ancestor_states.size());
+    for (const State &state : ancestor_states) {
+        values.push_back(compute_heuristic(state));
+    }
+}
+
+void Heuristic::compute_batch_results(
+    const vector<EvaluationContext *> &eval_contexts) {
+    /*
+      Contexts that ask for preferred operators or whose value is cached
+      are left to compute_result.
+    */
+    vector<EvaluationContext *> batch;
+    vector<State> states;
+    for (EvaluationContext *eval_context : eval_contexts) {
+        const State &state = eval_context->get_state();
+        if (eval_context->has_result(this) ||
+            eval_context->get_calculate_preferred() ||
+            (cache_evaluator_values && has_clean_cached_value(state))) {
+            continue;
+        }
+        batch.push_back(eval_context);
+        states.push_back(state);
+    }
+
+    if (!batch.empty()) {
+        vector<int> values;
+        compute_heuristic_batch(states, values);
+        preferred_operators.clear();
+        assert(values.size() == batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            int heuristic = values[i];
+            assert(heuristic == DEAD_END || heuristic >= 0);
+            if (cache_evaluator_values) {
+                set_cached_value(states[i], heuristic);
+            }
+            if (cache_preferred_operators &&
+                has_cached_preferred_operators(states[i])) {
+                // Batch evaluation discards preferred operators.
+                release_preferred_operators_of(states[i]);
+            }
+            EvaluationResult result;
+            result.set_count_evaluation(true);
+            result.set_evaluator_value(
+                heuristic == DEAD_END ? EvaluationResult::INFTY : heuristic);
+            batch[i]->store_result(this, move(result));
+        }
+    }
+
+    Evaluator::compute_batch_results(eval_contexts);
+}
+
 bool Heuristic::does_cache_estimates() const {
     return cache_evaluator_values;
 }
 
 bool Heuristic::is_estimate_cached(const State &state) const {
-    return heuristic_cache[state].h != NO_VALUE;
+    return get_cached_value(state) != NO_VALUE;
 }
 
 int Heuristic::get_cached_estimate(const State &state) const {
     assert(is_estimate_cached(state));
-    return heuristic_cache[state].h;
+    return get_cached_value(state);
 }
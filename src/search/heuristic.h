@@ -8,6 +8,7 @@
 
 #include "algorithms/ordered_set.h"
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -19,17 +20,49 @@ class Options;
 }
 
 class Heuristic : public Evaluator {
+    /*
+      HEntry stores h + 2 (so that NO_VALUE and DEAD_END become 0 and 1)
+      in 15 bits and the dirty flag in the remaining bit, so a cached
+      value costs 2 bytes per state.
+
+      When the first value that does not fit is cached, the heuristic
+      switches to WideHEntry (4 bytes per state) for good. States cached
+      before the switch keep their HEntry until they are cached again;
+      their wide entries hold NO_VALUE until then.
+    */
     struct HEntry {
-        /* dirty is conceptually a bool, but Visual C++ does not support
-           packing ints and bools together in a bitfield. */
+        std::uint16_t code : 15;
+        std::uint16_t dirty : 1;
+
+        HEntry(int h, bool dirty)
+            : code(h - NO_VALUE), dirty(dirty) {
+        }
+
+        int get_h() const {
+            return code + NO_VALUE;
+        }
+    };
+    static_assert(sizeof(HEntry) == 2, "HEntry has unexpected size.");
+
+    struct WideHEntry {
         int h : 31;
         unsigned int dirty : 1;
 
-        HEntry(int h, bool dirty)
+        WideHEntry(int h, bool dirty)
             : h(h), dirty(dirty) {
         }
     };
-    static_assert(sizeof(HEntry) == 4, "HEntry has unexpected size.");
+    static_assert(sizeof(WideHEntry) == 4, "WideHEntry has unexpected size.");
+
+    struct PreferredOperatorRecord {
+        // Position in cached_preferred_operators or -1 if released.
+        int begin;
+        int size;
+
+        PreferredOperatorRecord(int begin, int size)
+            : begin(begin), size(size) {
+        }
+    };
 
     /*
       TODO: We might want to get rid of the preferred_operators
@@ -44,7 +77,6 @@ class Heuristic : public Evaluator {
     */
     ordered_set::OrderedSet<OperatorID> preferred_operators;
 
-protected:
     /*
       Cache for saving h values
       Before accessing this cache always make sure that the cache_evaluator_values
@@ -52,8 +84,44 @@ protected:
       entries for all existing states
     */
     PerStateInformation<HEntry> heuristic_cache;
+    PerStateInformation<WideHEntry> wide_heuristic_cache;
+    bool use_wide_entries;
+
+    // Returns NO_VALUE if no value is cached for the state.
+    int get_cached_value(const State &state) const;
+    bool has_clean_cached_value(const State &state) const;
+    void set_cached_value(const State &state, int h);
+
+    /*
+      Preferred operators of the states in heuristic_cache, so that a
+      cached entry can also answer requests that need preferred
+      operators. Most heuristics are never asked for preferred
+      operators, so we only start recording them with the first such
+      request.
+
+      Per state, we store the ID of a record that points to the
+      state's operators in cached_preferred_operators. When a state is
+      evaluated again, its new operators overwrite the old ones if they
+      fit and are appended otherwise. Operators that are no longer used
+      are removed once they make up half of the vector.
+    */
+    PerStateInformation<int> preferred_operator_record_ids;
+    std::vector<PreferredOperatorRecord> preferred_operator_records;
+    std::vector<int> free_preferred_operator_record_ids;
+    std::vector<OperatorID> cached_preferred_operators;
+    bool cache_preferred_operators;
+    int num_dead_preferred_operators;
+
+    bool has_cached_preferred_operators(const State &state) const;
+    void cache_preferred_operators_of(const State &state, bool dead_end);
+    void release_preferred_operators_of(const State &state);
+    void compact_cached_preferred_operators();
+
+protected:
     bool cache_evaluator_values;
 
+    void mark_cached_value_dirty(const State &state);
+
     // Hold a reference to the task implementation and pass it to objects that need it.
     const std::shared_ptr<AbstractTask> task;
     // Use task_proxy to access task information.
@@ -63,6 +131,15 @@ protected:
 
     virtual int compute_heuristic(const State &ancestor_state) = 0;
 
+    /*
+      Compute the heuristic values of several states at once. Heuristics
+      that can share work between the states override this method. The
+      default implementation calls compute_heuristic for each state.
+      Preferred operators marked during batch evaluation are discarded.
+    */
+    virtual void compute_heuristic_batch(
+        const std::vector<State> &ancestor_states, std::vector<int> &values);
+
     /*
       Usage note: Marking the same operator as preferred multiple times
       is OK -- it will only appear once in the list of preferred
@@ -85,6 +162,8 @@ public:
 
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual void compute_batch_results(
+        const std::vector<EvaluationContext *> &eval_contexts) override;
 
     virtual bool does_cache_estimates() const override;
     virtual bool is_estimate_cached(const State &state) const override;
@@ -145,6 +145,12 @@ int AdditiveHeuristic::compute_heuristic(const State &ancestor_state) {
     return h;
 }
 
+void AdditiveHeuristic::compute_heuristic_batch(
+    const vector<State> &ancestor_states, vector<int> &values) {
+    if (compute_relaxed_batch(ancestor_states, values, true, MAX_COST_VALUE))
+        write_overflow_warning();
+}
+
 void AdditiveHeuristic::compute_heuristic_for_cegar(const State &state) {
     compute_heuristic(state);
 }
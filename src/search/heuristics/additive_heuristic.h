@@ -7,6 +7,7 @@
 #include "../utils/collections.h"
 
 #include <cassert>
+#include <vector>
 
 class State;
 
@@ -61,6 +62,9 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     void write_overflow_warning();
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual void compute_heuristic_batch(
+        const std::vector<State> &ancestor_states,
+        std::vector<int> &values) override;
 
     // Common part of h^add and h^ff computation.
     int compute_add_and_ff(const State &state);
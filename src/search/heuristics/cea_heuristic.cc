@@ -107,11 +107,13 @@ struct LocalProblemNode {
 
 struct LocalProblem {
     int base_priority;
+    // The problem is set up iff its epoch equals the heuristic's current_epoch.
+    int epoch;
     vector<LocalProblemNode> nodes;
     vector<int> *context_variables;
 public:
     LocalProblem()
-        : base_priority(-1) {
+        : base_priority(-1), epoch(-1) {
     }
 
     ~LocalProblem() {
@@ -209,14 +211,15 @@ inline void ContextEnhancedAdditiveHeuristic::add_to_heap(
 
 bool ContextEnhancedAdditiveHeuristic::is_local_problem_set_up(
     const LocalProblem *problem) const {
-    return problem->base_priority != -1;
+    return problem->epoch == current_epoch;
 }
 
 void ContextEnhancedAdditiveHeuristic::set_up_local_problem(
     LocalProblem *problem, int base_priority,
     int start_value, const State &state) {
-    assert(problem->base_priority == -1);
+    assert(!is_local_problem_set_up(problem));
     problem->base_priority = base_priority;
+    problem->epoch = current_epoch;
 
     for (auto &to_node : problem->nodes) {
         to_node.expanded = false;
@@ -394,9 +397,8 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(
     const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     initialize_heap();
-    goal_problem->base_priority = -1;
-    for (LocalProblem *problem : local_problems)
-        problem->base_priority = -1;
+    // Start a new epoch instead of resetting all local problems.
+    ++current_epoch;
 
     set_up_local_problem(goal_problem, 0, 0, state);
 
@@ -415,7 +417,8 @@ ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
     : Heuristic(tasks::get_default_value_axioms_task_if_needed(
                     transform, axioms),
                 cache_estimates, description, verbosity),
-      min_action_cost(task_properties::get_min_operator_cost(task_proxy)) {
+      min_action_cost(task_properties::get_min_operator_cost(task_proxy)),
+      current_epoch(0) {
     if (log.is_at_least_normal()) {
         log << "Initializing context-enhanced additive heuristic..." << endl;
     }
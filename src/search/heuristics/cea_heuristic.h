@@ -24,6 +24,8 @@ class ContextEnhancedAdditiveHeuristic : public Heuristic {
     LocalProblem *goal_problem;
     LocalProblemNode *goal_node;
     int min_action_cost;
+    // Number of heuristic evaluations so far (see LocalProblem::epoch).
+    int current_epoch;
 
     priority_queues::AdaptiveQueue<LocalProblemNode *> node_queue;
 
@@ -5,7 +5,6 @@
 #include "../task_utils/causal_graph.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
-#include "../utils/math.h"
 
 #include <algorithm>
 #include <cassert>
@@ -13,12 +12,22 @@
 #include <vector>
 
 using namespace std;
+using namespace domain_transition_graph;
 
 namespace cg_heuristic {
 const int CGCache::NOT_COMPUTED;
 
 CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProxy &log)
-    : task_proxy(task_proxy) {
+    : task_proxy(task_proxy),
+      max_cache_memory(static_cast<size_t>(max_cache_size) * sizeof(int)),
+      cache_memory(0),
+      clock_hand(0),
+      current_evaluation(0),
+      num_hits(0),
+      num_misses(0),
+      num_stores(0),
+      num_evictions(0),
+      num_rejected_stores(0) {
     if (log.is_at_least_normal()) {
         log << "Initializing heuristic cache... " << flush;
     }
@@ -54,78 +63,142 @@ CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProx
                               depends_on[var].end());
     }
 
-    cache.resize(var_count);
-    helpful_transition_cache.resize(var_count);
-
-    for (int var = 0; var < var_count; ++var) {
-        int required_cache_size = compute_required_cache_size(
-            var, depends_on[var], max_cache_size);
-        if (required_cache_size != -1) {
-            cache[var].resize(required_cache_size, NOT_COMPUTED);
-            helpful_transition_cache[var].resize(required_cache_size, nullptr);
-        }
-    }
-
     if (log.is_at_least_normal()) {
         log << "done!" << endl;
     }
 }
 
-int CGCache::compute_required_cache_size(
-    int var_id, const vector<int> &depends_on, int max_cache_size) const {
-    /*
-      Compute the size of the cache required for variable with ID "var_id",
-      which depends on the variables in "depends_on". Requires that the caches
-      for all variables in "depends_on" have already been allocated. Returns -1
-      if the variable cannot be cached because the required cache size would be
-      too large.
-    */
+const vector<int> &CGCache::compute_key(
+    int var, const State &state, int from_val) {
+    key_buffer.clear();
+    key_buffer.push_back(var);
+    key_buffer.push_back(from_val);
+    for (int dep_var : depends_on[var])
+        key_buffer.push_back(state[dep_var].get_value());
+    return key_buffer;
+}
 
-    VariablesProxy variables = task_proxy.get_variables();
-    int var_domain = variables[var_id].get_domain_size();
-    if (!utils::is_product_within_limit(var_domain, var_domain - 1,
-                                        max_cache_size))
-        return -1;
+CGCache::Entry *CGCache::find_entry(int var, const State &state, int from_val) {
+    auto it = entry_ids.find(compute_key(var, state, from_val));
+    if (it == entry_ids.end())
+        return nullptr;
+    Entry &entry = entries[it->second];
+    entry.last_used = current_evaluation;
+    entry.referenced = true;
+    return &entry;
+}
 
-    int required_size = var_domain * (var_domain - 1);
+int CGCache::lookup(int var, const State &state, int from_val, int to_val) {
+    assert(from_val != to_val);
+    const Entry *entry = find_entry(var, state, from_val);
+    if (!entry) {
+        ++num_misses;
+        return NOT_COMPUTED;
+    }
+    ++num_hits;
+    assert(utils::in_bounds(to_val, entry->distances));
+    return entry->distances[to_val];
+}
 
-    for (int depend_var_id : depends_on) {
-        int depend_var_domain = variables[depend_var_id].get_domain_size();
+ValueTransitionLabel *CGCache::lookup_helpful_transition(
+    int var, const State &state, int from_val, int to_val, int &distance) {
+    assert(from_val != to_val);
+    const Entry *entry = find_entry(var, state, from_val);
+    if (!entry)
+        return nullptr;
+    distance = entry->distances[to_val];
+    return entry->helpful_transitions[to_val];
+}
 
-        /*
-          If var depends on a variable var_i that is not cached, then
-          it cannot be cached. This is possible even if var would have
-          an acceptable cache size because the domain of var_i
-          contributes quadratically to its own cache size but only
-          linearly to the cache size of var.
-        */
-        if (cache[depend_var_id].empty())
-            return -1;
+size_t CGCache::get_entry_memory(size_t key_size, size_t num_values) {
+    /*
+      We assume that a hash table node holds a pointer to the next node
+      and the hash value, and that there is one bucket pointer per node.
+    */
+    size_t node_memory = sizeof(EntryIDMap::value_type) +
+        sizeof(void *) + sizeof(size_t) + sizeof(void *);
+    return sizeof(Entry) + node_memory + key_size * sizeof(int) +
+           num_values * (sizeof(int) + sizeof(ValueTransitionLabel *));
+}
 
-        if (!utils::is_product_within_limit(required_size, depend_var_domain,
-                                            max_cache_size))
-            return -1;
+void CGCache::evict_entry(size_t entry_id) {
+    Entry &entry = entries[entry_id];
+    cache_memory -= get_entry_memory(
+        entry.id_node->first.size(), entry.distances.size());
+    // Erase via an iterator, since the key is destroyed with the node.
+    entry_ids.erase(entry_ids.find(entry.id_node->first));
+    if (entry_id != entries.size() - 1) {
+        entry = move(entries.back());
+        entry.id_node->second = entry_id;
+    }
+    entries.pop_back();
+    ++num_evictions;
+}
 
-        required_size *= depend_var_domain;
+bool CGCache::make_room(size_t memory) {
+    /*
+      CLOCK eviction: sweep over the entries, giving referenced entries
+      a second chance and skipping entries used in the current
+      evaluation. Two full sweeps suffice to clear all reference bits,
+      so if there is still no room afterwards, only protected entries
+      are left.
+    */
+    if (memory > max_cache_memory)
+        return false;
+    size_t steps_left = 2 * entries.size();
+    while (cache_memory + memory > max_cache_memory && steps_left > 0) {
+        --steps_left;
+        if (clock_hand >= entries.size())
+            clock_hand = 0;
+        Entry &entry = entries[clock_hand];
+        if (entry.last_used == current_evaluation) {
+            ++clock_hand;
+        } else if (entry.referenced) {
+            entry.referenced = false;
+            ++clock_hand;
+        } else {
+            // The last entry is moved to clock_hand, so keep it there.
+            evict_entry(clock_hand);
+        }
     }
+    return cache_memory + memory <= max_cache_memory;
+}
 
-    return required_size;
+void CGCache::store(
+    int var, const State &state, int from_val,
+    const vector<int> &distances,
+    const vector<ValueTransitionLabel *> &helpful_transitions) {
+    assert(distances.size() == helpful_transitions.size());
+    size_t memory = get_entry_memory(
+        2 + depends_on[var].size(), distances.size());
+    if (!make_room(memory)) {
+        ++num_rejected_stores;
+        return;
+    }
+    const vector<int> &key = compute_key(var, state, from_val);
+    auto result = entry_ids.emplace(key, entries.size());
+    assert(result.second);
+    entries.push_back(
+        {&*result.first, distances, helpful_transitions,
+         current_evaluation, false});
+    cache_memory += memory;
+    ++num_stores;
 }
 
-int CGCache::get_index(int var, const State &state,
-                       int from_val, int to_val) const {
-    assert(is_cached(var));
-    assert(from_val != to_val);
-    int index = from_val;
-    int multiplier = task_proxy.get_variables()[var].get_domain_size();
-    for (int dep_var : depends_on[var]) {
-        index += state[dep_var].get_value() * multiplier;
-        multiplier *= task_proxy.get_variables()[dep_var].get_domain_size();
+void CGCache::print_statistics(utils::LogProxy &log) const {
+    if (log.is_at_least_normal()) {
+        int num_lookups = num_hits + num_misses;
+        double hit_rate = num_lookups
+            ? static_cast<double>(num_hits) / num_lookups : 0.0;
+        log << "CG cache lookups: " << num_lookups
+            << ", hits: " << num_hits
+            << " (" << hit_rate * 100 << "%)" << endl;
+        log << "CG cache stores: " << num_stores
+            << ", evictions: " << num_evictions
+            << ", rejected stores: " << num_rejected_stores << endl;
+        log << "CG cache memory: " << cache_memory / 1024 << " KB of "
+            << max_cache_memory / 1024 << " KB in " << entries.size()
+            << " entries" << endl;
     }
-    if (to_val > from_val)
-        --to_val;
-    index += to_val * multiplier;
-    assert(utils::in_bounds(index, cache[var]));
-    return index;
 }
 }
@@ -3,6 +3,8 @@
 
 #include "../task_proxy.h"
 
+#include "../utils/hash.h"
+
 #include <vector>
 
 namespace domain_transition_graph {
@@ -14,45 +16,94 @@ class LogProxy;
 }
 
 namespace cg_heuristic {
+/*
+  Cache for the distances computed by the causal graph heuristic.
+
+  An entry holds the distances (and helpful transitions) from one start
+  value of a variable to all other values of the variable, for one
+  assignment to the variables that the variable transitively depends
+  on in the reduced causal graph. Entries are kept in a hash table, so
+  every variable can be cached regardless of its domain size and the
+  number of variables it depends on.
+
+  The memory of all entries is bounded by max_cache_size distances, i.e.,
+  max_cache_size * sizeof(int) bytes. Each entry is charged for all of
+  its memory: the distances and helpful transitions, the key and the
+  overhead of the entry and its hash table node. The key is only stored
+  in the hash table. When a new entry does not fit, entries are evicted with the CLOCK
+  approximation of least-recently-used eviction. Entries that have been
+  used during the current heuristic evaluation are never evicted,
+  because the helpful transitions of the evaluation are extracted from
+  them after the distances have been computed. If only such entries
+  are left, the new entry is not stored.
+*/
 class CGCache {
+    /*
+      Maps the key of each entry, i.e., the variable, the start value and
+      the values of the depends_on variables, to the index of the entry.
+    */
+    using EntryIDMap = utils::HashMap<std::vector<int>, int>;
+
+    struct Entry {
+        // Node of the entry in entry_ids. Nodes keep their address.
+        EntryIDMap::value_type *id_node;
+        // Indexed by the target value.
+        std::vector<int> distances;
+        std::vector<domain_transition_graph::ValueTransitionLabel *> helpful_transitions;
+        int last_used;
+        bool referenced;
+    };
+
     TaskProxy task_proxy;
-    std::vector<std::vector<int>> cache;
-    std::vector<std::vector<domain_transition_graph::ValueTransitionLabel *>> helpful_transition_cache;
     std::vector<std::vector<int>> depends_on;
 
-    int get_index(int var, const State &state, int from_val, int to_val) const;
-    int compute_required_cache_size(
-        int var_id, const std::vector<int> &depends_on, int max_cache_size) const;
+    std::vector<Entry> entries;
+    EntryIDMap entry_ids;
+    std::vector<int> key_buffer;
+    // In bytes.
+    size_t max_cache_memory;
+    size_t cache_memory;
+    size_t clock_hand;
+    int current_evaluation;
+
+    int num_hits;
+    int num_misses;
+    int num_stores;
+    int num_evictions;
+    int num_rejected_stores;
+
+    const std::vector<int> &compute_key(
+        int var, const State &state, int from_val);
+    Entry *find_entry(int var, const State &state, int from_val);
+    static size_t get_entry_memory(size_t key_size, size_t num_values);
+    void evict_entry(size_t entry_id);
+    bool make_room(size_t memory);
 public:
     static const int NOT_COMPUTED = -2;
 
     CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProxy &log);
 
-    bool is_cached(int var) const {
-        return !cache[var].empty();
+    // Protects all entries used from now on until the next call.
+    void start_evaluation() {
+        ++current_evaluation;
     }
 
-    int lookup(int var, const State &state, int from_val, int to_val) const {
-        return cache[var][get_index(var, state, from_val, to_val)];
-    }
-
-    void store(int var, const State &state,
-               int from_val, int to_val, int cost) {
-        cache[var][get_index(var, state, from_val, to_val)] = cost;
-    }
+    int lookup(int var, const State &state, int from_val, int to_val);
 
+    /*
+      Return the helpful transition for reaching to_val from from_val and
+      set distance to the cached distance, or return nullptr if the
+      entry is not cached.
+    */
     domain_transition_graph::ValueTransitionLabel *lookup_helpful_transition(
-        int var, const State &state, int from_val, int to_val) const {
-        int index = get_index(var, state, from_val, to_val);
-        return helpful_transition_cache[var][index];
-    }
+        int var, const State &state, int from_val, int to_val, int &distance);
 
-    void store_helpful_transition(
-        int var, const State &state, int from_val, int to_val,
-        domain_transition_graph::ValueTransitionLabel *helpful_transition) {
-        int index = get_index(var, state, from_val, to_val);
-        helpful_transition_cache[var][index] = helpful_transition;
-    }
+    void store(
+        int var, const State &state, int from_val,
+        const std::vector<int> &distances,
+        const std::vector<domain_transition_graph::ValueTransitionLabel *> &helpful_transitions);
+
+    void print_statistics(utils::LogProxy &log) const;
 };
 }
 
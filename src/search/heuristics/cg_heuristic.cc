@@ -24,8 +24,6 @@ CGHeuristic::CGHeuristic(
     : Heuristic(tasks::get_default_value_axioms_task_if_needed(
                     transform, axioms),
                 cache_estimates, description, verbosity),
-      cache_hits(0),
-      cache_misses(0),
       helpful_transition_extraction_counter(0),
       min_action_cost(task_properties::get_min_operator_cost(task_proxy)) {
     if (log.is_at_least_normal()) {
@@ -46,6 +44,11 @@ CGHeuristic::CGHeuristic(
     transition_graphs = factory.build_dtgs();
 }
 
+CGHeuristic::~CGHeuristic() {
+    if (cache)
+        cache->print_statistics(log);
+}
+
 bool CGHeuristic::dead_ends_are_reliable() const {
     return false;
 }
@@ -80,6 +83,8 @@ void CGHeuristic::setup_domain_transition_graphs() {
     }
     // Reset "dirty bits" for helpful transitions.
     ++helpful_transition_extraction_counter;
+    if (cache)
+        cache->start_evaluation();
 }
 
 int CGHeuristic::get_transition_cost(const State &state,
@@ -91,20 +96,17 @@ int CGHeuristic::get_transition_cost(const State &state,
 
     int var_no = dtg->var;
 
-    // Check cache.
-    bool use_the_cache = cache && cache->is_cached(var_no);
-    if (use_the_cache) {
-        int cached_val = cache->lookup(var_no, state, start_val, goal_val);
-        if (cached_val != CGCache::NOT_COMPUTED) {
-            ++cache_hits;
-            return cached_val;
-        }
-    } else {
-        ++cache_misses;
-    }
-
     ValueNode *start = &dtg->nodes[start_val];
+    bool computed_now = false;
     if (start->distances.empty()) {
+        // Check cache.
+        if (cache) {
+            int cached_val = cache->lookup(var_no, state, start_val, goal_val);
+            if (cached_val != CGCache::NOT_COMPUTED)
+                return cached_val;
+        }
+        computed_now = true;
+
         // Initialize data of initial node.
         start->distances.resize(dtg->nodes.size(), numeric_limits<int>::max());
         start->helpful_transitions.resize(dtg->nodes.size(), nullptr);
@@ -205,19 +207,18 @@ int CGHeuristic::get_transition_cost(const State &state,
         }
     }
 
-    if (use_the_cache) {
+    if (cache && computed_now) {
+#ifndef NDEBUG
         int num_values = start->distances.size();
         for (int val = 0; val < num_values; ++val) {
-            if (val == start_val)
-                continue;
-            int distance = start->distances[val];
-            ValueTransitionLabel *helpful = start->helpful_transitions[val];
-            // We should have a helpful transition iff distance is infinite.
-            assert((distance == numeric_limits<int>::max()) == !helpful);
-            cache->store(var_no, state, start_val, val, distance);
-            cache->store_helpful_transition(
-                var_no, state, start_val, val, helpful);
+            // We should have a helpful transition iff distance is finite.
+            assert(val == start_val ||
+                   (start->distances[val] == numeric_limits<int>::max()) ==
+                   !start->helpful_transitions[val]);
         }
+#endif
+        cache->store(var_no, state, start_val,
+                     start->distances, start->helpful_transitions);
     }
 
     return start->distances[goal_val];
@@ -254,14 +255,12 @@ void CGHeuristic::mark_helpful_transitions(const State &state,
     dtg->last_helpful_transition_extraction_time =
         helpful_transition_extraction_counter;
 
-    ValueTransitionLabel *helpful;
-    int cost;
+    ValueTransitionLabel *helpful = nullptr;
+    int cost = 0;
     // Check cache.
-    if (cache && cache->is_cached(var_no)) {
-        helpful = cache->lookup_helpful_transition(var_no, state, from, to);
-        cost = cache->lookup(var_no, state, from, to);
-        assert(helpful);
-    } else {
+    if (cache)
+        helpful = cache->lookup_helpful_transition(var_no, state, from, to, cost);
+    if (!helpful) {
         ValueNode *start_node = &dtg->nodes[from];
         assert(!start_node->helpful_transitions.empty());
         helpful = start_node->helpful_transitions[to];
@@ -295,7 +294,11 @@ public:
 
         add_option<int>(
             "max_cache_size",
-            "maximum number of cached entries per variable (set to 0 to disable cache)",
+            "maximum memory of the cache over all variables, measured in "
+            "cached distances (4 bytes each). Each entry is charged for its "
+            "distances, helpful transitions, key and bookkeeping. When the "
+            "cache is full, the least recently used entries are evicted "
+            "(set to 0 to disable cache)",
             "1000000",
             plugins::Bounds("0", "infinity"));
         tasks::add_axioms_option_to_feature(*this);
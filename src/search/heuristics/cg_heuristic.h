@@ -24,8 +24,6 @@ class CGHeuristic : public Heuristic {
     std::vector<std::unique_ptr<domain_transition_graph::DomainTransitionGraph>> transition_graphs;
 
     std::unique_ptr<CGCache> cache;
-    int cache_hits;
-    int cache_misses;
 
     int helpful_transition_extraction_counter;
 
@@ -50,6 +48,7 @@ public:
         const std::shared_ptr<AbstractTask> &transform,
         bool cache_estimates, const std::string &description,
         utils::Verbosity verbosity);
+    virtual ~CGHeuristic() override;
     virtual bool dead_ends_are_reliable() const override;
 };
 }
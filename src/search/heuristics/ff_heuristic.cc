@@ -74,6 +74,11 @@ int FFHeuristic::compute_heuristic(const State &ancestor_state) {
     return h_ff;
 }
 
+void FFHeuristic::compute_heuristic_batch(
+    const vector<State> &ancestor_states, vector<int> &values) {
+    Heuristic::compute_heuristic_batch(ancestor_states, values);
+}
+
 class FFHeuristicFeature
     : public plugins::TypedFeature<Evaluator, FFHeuristic> {
 public:
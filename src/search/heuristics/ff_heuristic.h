@@ -31,6 +31,10 @@ class FFHeuristic : public additive_heuristic::AdditiveHeuristic {
         const State &state, PropID goal_id);
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    // FF values depend on the relaxed plan, so states are evaluated one by one.
+    virtual void compute_heuristic_batch(
+        const std::vector<State> &ancestor_states,
+        std::vector<int> &values) override;
 public:
     FFHeuristic(
         tasks::AxiomHandlingType axioms,
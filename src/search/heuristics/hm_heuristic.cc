@@ -4,10 +4,12 @@
 
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <limits>
-#include <set>
 
 using namespace std;
 
@@ -19,14 +21,31 @@ HMHeuristic::HMHeuristic(
     : Heuristic(transform, cache_estimates, description, verbosity),
       m(m),
       has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
-      goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
+      num_facts(0),
+      needs_full_pass(false) {
     if (log.is_at_least_normal()) {
         log << "Using h^" << m << "." << endl;
-        log << "The implementation of the h^m heuristic is preliminary." << endl
-            << "It is SLOOOOOOOOOOOW." << endl
-            << "Please do not use this for comparison!" << endl;
     }
-    generate_all_tuples();
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+        fact_vars.insert(fact_vars.end(), var.get_domain_size(), var.get_id());
+    }
+    int num_variables = task_proxy.get_variables().size();
+    precondition_value.resize(num_variables, -1);
+    effect_value.resize(num_variables, -1);
+    is_new_fact.resize(num_facts, false);
+
+    compute_table_size();
+    hm_table.resize(size_offsets[m + 1]);
+    build_operators();
+    collect_subtuple_ranks(
+        get_tuple(task_properties::get_fact_pairs(task_proxy.get_goals())),
+        goal_ranks);
+    in_worklist.resize(operators.size(), false);
+    if (log.is_at_least_normal()) {
+        log << "h^m table entries: " << hm_table.size() << endl;
+    }
 }
 
 
@@ -35,222 +54,295 @@ bool HMHeuristic::dead_ends_are_reliable() const {
 }
 
 
-int HMHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-    if (task_properties::is_goal_state(task_proxy, state)) {
-        return 0;
-    } else {
-        Tuple s_tup = task_properties::get_fact_pairs(state);
-
-        init_hm_table(s_tup);
-        update_hm_table();
-
-        int h = eval(goals);
-
-        if (h == numeric_limits<int>::max())
-            return DEAD_END;
-        return h;
+void HMHeuristic::compute_table_size() {
+    binomials.assign(m + 1, vector<int>(num_facts, 0));
+    size_offsets.assign(m + 2, 0);
+    int64_t max_rank = numeric_limits<int>::max();
+    for (int f = 0; f < num_facts; ++f) {
+        int64_t binomial = 1;
+        for (int k = 1; k <= m; ++k) {
+            // C(f, k) = C(f, k - 1) * (f - k + 1) / k
+            binomial = binomial * (f - k + 1) / k;
+            if (binomial > max_rank)
+                binomial = max_rank;
+            binomials[k][f] = binomial;
+        }
+    }
+    int64_t offset = 0;
+    for (int k = 1; k <= m; ++k) {
+        size_offsets[k] = offset;
+        // The number of tuples of size k is C(num_facts, k).
+        int64_t num_tuples = 1;
+        for (int i = 1; i <= k && num_tuples <= max_rank; ++i)
+            num_tuples = num_tuples * (num_facts - i + 1) / i;
+        offset += num_tuples;
+        if (offset > max_rank) {
+            cerr << "h^" << m << " table is too large." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
     }
+    size_offsets[m + 1] = offset;
 }
 
 
-void HMHeuristic::init_hm_table(const Tuple &t) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        int h_val = check_tuple_in_tuple(tuple, t);
-        hm_table[tuple] = h_val;
-    }
+int HMHeuristic::rank(const Tuple &t) const {
+    assert(!t.empty() && static_cast<int>(t.size()) <= m);
+    int result = size_offsets[t.size()];
+    for (size_t i = 0; i < t.size(); ++i)
+        result += binomials[i + 1][t[i]];
+    return result;
 }
 
 
-void HMHeuristic::update_hm_table() {
-    do {
-        was_updated = false;
-
-        for (OperatorProxy op : task_proxy.get_operators()) {
-            Tuple pre = get_operator_pre(op);
-
-            int c1 = eval(pre);
-            if (c1 != numeric_limits<int>::max()) {
-                Tuple eff = get_operator_eff(op);
-                vector<Tuple> partial_effs;
-                generate_all_partial_tuples(eff, partial_effs);
-                for (Tuple &partial_eff : partial_effs) {
-                    update_hm_entry(partial_eff, c1 + op.get_cost());
-
-                    int eff_size = partial_eff.size();
-                    if (eff_size < m) {
-                        extend_tuple(partial_eff, op);
-                    }
-                }
-            }
-        }
-    } while (was_updated);
+HMHeuristic::Tuple HMHeuristic::get_tuple(const vector<FactPair> &facts) const {
+    Tuple tuple;
+    tuple.reserve(facts.size());
+    for (const FactPair &fact : facts)
+        tuple.push_back(get_fact_id(fact));
+    sort(tuple.begin(), tuple.end());
+    tuple.erase(unique(tuple.begin(), tuple.end()), tuple.end());
+    return tuple;
 }
 
 
-void HMHeuristic::extend_tuple(const Tuple &t, const OperatorProxy &op) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        bool contradict = false;
-        for (const FactPair &fact : tuple) {
-            if (contradict_effect_of(op, fact.var, fact.value)) {
-                contradict = true;
-                break;
-            }
-        }
-        if (!contradict && (tuple.size() > t.size()) && (check_tuple_in_tuple(t, tuple) == 0)) {
-            Tuple pre = get_operator_pre(op);
-
-            Tuple others;
-            for (const FactPair &fact : tuple) {
-                if (find(t.begin(), t.end(), fact) == t.end()) {
-                    others.push_back(fact);
-                    if (find(pre.begin(), pre.end(), fact) == pre.end()) {
-                        pre.push_back(fact);
-                    }
-                }
-            }
-
-            sort(pre.begin(), pre.end());
+void HMHeuristic::collect_subtuple_ranks(
+    const Tuple &base, vector<int> &ranks, bool only_with_new_facts) const {
+    ranks.clear();
+    collect_subtuple_ranks_aux(
+        base, ranks, only_with_new_facts, 0, 0, -1, 0, false);
+}
 
-            set<int> vars;
-            bool is_valid = true;
-            for (const FactPair &fact : pre) {
-                if (vars.count(fact.var) != 0) {
-                    is_valid = false;
-                    break;
-                }
-                vars.insert(fact.var);
-            }
 
-            if (is_valid) {
-                int c2 = eval(pre);
-                if (c2 != numeric_limits<int>::max()) {
-                    update_hm_entry(tuple, c2 + op.get_cost());
-                }
-            }
+void HMHeuristic::collect_subtuple_ranks_aux(
+    const Tuple &base, vector<int> &ranks, bool only_with_new_facts,
+    int index, int size, int last_var, int partial_rank,
+    bool has_new_fact) const {
+    int base_size = base.size();
+    for (int i = index; i < base_size; ++i) {
+        int fact = base[i];
+        // Facts of the same variable are adjacent in the sorted tuple.
+        if (fact_vars[fact] == last_var)
+            continue;
+        int rank_sum = partial_rank + binomials[size + 1][fact];
+        bool with_new_fact = has_new_fact || is_new_fact[fact];
+        if (!only_with_new_facts || with_new_fact)
+            ranks.push_back(size_offsets[size + 1] + rank_sum);
+        if (size + 1 < m) {
+            collect_subtuple_ranks_aux(
+                base, ranks, only_with_new_facts, i + 1, size + 1,
+                fact_vars[fact], rank_sum, with_new_fact);
         }
     }
 }
 
 
-int HMHeuristic::eval(const Tuple &t) const {
-    vector<Tuple> partial;
-    generate_all_partial_tuples(t, partial);
-    int max = 0;
-    for (Tuple &tuple : partial) {
-        assert(hm_table.count(tuple) == 1);
-
-        int h = hm_table.at(tuple);
-        if (h > max) {
-            max = h;
-        }
+void HMHeuristic::collect_partial_tuples(
+    const Tuple &base, Tuple &tuple, int index, vector<Tuple> &res) const {
+    int base_size = base.size();
+    for (int i = index; i < base_size; ++i) {
+        int fact = base[i];
+        if (!tuple.empty() && fact_vars[fact] == fact_vars[tuple.back()])
+            continue;
+        tuple.push_back(fact);
+        res.push_back(tuple);
+        if (static_cast<int>(tuple.size()) < m)
+            collect_partial_tuples(base, tuple, i + 1, res);
+        tuple.pop_back();
     }
-    return max;
 }
 
 
-int HMHeuristic::update_hm_entry(const Tuple &t, int val) {
-    assert(hm_table.count(t) == 1);
-    if (hm_table[t] > val) {
-        hm_table[t] = val;
-        was_updated = true;
+void HMHeuristic::build_operators() {
+    precondition_of.resize(num_facts);
+    OperatorsProxy ops = task_proxy.get_operators();
+    operators.reserve(ops.size());
+    for (OperatorProxy op : ops) {
+        HMOperator hm_op;
+        hm_op.cost = op.get_cost();
+        hm_op.preconditions =
+            get_tuple(task_properties::get_fact_pairs(op.get_preconditions()));
+        collect_subtuple_ranks(hm_op.preconditions, hm_op.precondition_ranks);
+        for (EffectProxy eff : op.get_effects())
+            hm_op.effects.push_back(eff.get_fact().get_pair());
+        Tuple tuple;
+        collect_partial_tuples(
+            get_tuple(hm_op.effects), tuple, 0, hm_op.partial_effects);
+        for (const Tuple &partial_eff : hm_op.partial_effects)
+            hm_op.partial_effect_ranks.push_back(rank(partial_eff));
+        for (int fact : hm_op.preconditions)
+            precondition_of[fact].push_back(operators.size());
+        operators.push_back(move(hm_op));
     }
-    return val;
 }
 
 
-int HMHeuristic::check_tuple_in_tuple(
-    const Tuple &tuple, const Tuple &big_tuple) const {
-    for (const FactPair &fact0 : tuple) {
-        bool found = false;
-        for (auto &fact1 : big_tuple) {
-            if (fact0 == fact1) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            return numeric_limits<int>::max();
-        }
+int HMHeuristic::compute_heuristic(const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        return 0;
+    } else {
+        init_hm_table(state);
+        update_hm_table();
+
+        int h = eval(goal_ranks);
+
+        if (h == numeric_limits<int>::max())
+            return DEAD_END;
+        return h;
     }
-    return 0;
 }
 
 
-HMHeuristic::Tuple HMHeuristic::get_operator_pre(const OperatorProxy &op) const {
-    Tuple preconditions = task_properties::get_fact_pairs(op.get_preconditions());
-    sort(preconditions.begin(), preconditions.end());
-    return preconditions;
+void HMHeuristic::init_hm_table(const State &state) {
+    fill(hm_table.begin(), hm_table.end(), numeric_limits<int>::max());
+    collect_subtuple_ranks(
+        get_tuple(task_properties::get_fact_pairs(state)), scratch_ranks);
+    for (int r : scratch_ranks)
+        hm_table[r] = 0;
 }
 
 
-HMHeuristic::Tuple HMHeuristic::get_operator_eff(const OperatorProxy &op) const {
-    Tuple effects;
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(eff.get_fact().get_pair());
+void HMHeuristic::enqueue_operator(int op_id) {
+    if (!in_worklist[op_id]) {
+        in_worklist[op_id] = true;
+        worklist.push_back(op_id);
     }
-    sort(effects.begin(), effects.end());
-    return effects;
 }
 
 
-bool HMHeuristic::contradict_effect_of(
-    const OperatorProxy &op, int var, int val) const {
-    for (EffectProxy eff : op.get_effects()) {
-        FactProxy fact = eff.get_fact();
-        if (fact.get_variable().get_id() == var && fact.get_value() != val) {
-            return true;
+void HMHeuristic::update_hm_table() {
+    int num_operators = operators.size();
+    for (int op_id = 0; op_id < num_operators; ++op_id)
+        enqueue_operator(op_id);
+    needs_full_pass = false;
+
+    while (true) {
+        if (worklist.empty()) {
+            if (!needs_full_pass)
+                break;
+            needs_full_pass = false;
+            for (int op_id = 0; op_id < num_operators; ++op_id)
+                enqueue_operator(op_id);
         }
+        int op_id = worklist.front();
+        worklist.pop_front();
+        in_worklist[op_id] = false;
+        process_operator(op_id);
     }
-    return false;
 }
 
 
-void HMHeuristic::generate_all_tuples() {
-    Tuple t;
-    generate_all_tuples_aux(0, m, t);
+void HMHeuristic::process_operator(int op_id) {
+    const HMOperator &op = operators[op_id];
+    int c1 = eval(op.precondition_ranks);
+    if (c1 == numeric_limits<int>::max())
+        return;
+
+    for (const FactPair &fact : op.effects)
+        effect_value[fact.var] = fact.value;
+    for (int fact : op.preconditions)
+        precondition_value[fact_vars[fact]] = fact - fact_offsets[fact_vars[fact]];
+
+    Tuple extension;
+    int num_partial_effs = op.partial_effects.size();
+    for (int i = 0; i < num_partial_effs; ++i) {
+        const Tuple &partial_eff = op.partial_effects[i];
+        update_hm_entry(partial_eff, op.partial_effect_ranks[i], c1 + op.cost);
+        if (static_cast<int>(partial_eff.size()) < m)
+            extend_tuple(partial_eff, op, extension, 0, c1);
+    }
+
+    for (const FactPair &fact : op.effects)
+        effect_value[fact.var] = -1;
+    for (int fact : op.preconditions)
+        precondition_value[fact_vars[fact]] = -1;
 }
 
 
-void HMHeuristic::generate_all_tuples_aux(int var, int sz, const Tuple &base) {
-    int num_variables = task_proxy.get_variables().size();
-    for (int i = var; i < num_variables; ++i) {
-        int domain_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain_size; ++j) {
-            Tuple tuple(base);
-            tuple.emplace_back(i, j);
-            hm_table[tuple] = 0;
-            if (sz > 1) {
-                generate_all_tuples_aux(i + 1, sz - 1, tuple);
+/*
+  Add the facts in extension and one more fact (with index >= first_fact)
+  to t. The added facts must not contradict the effects or preconditions
+  of op. The cost of the extended tuple is bounded by the cost of
+  reaching the precondition together with the added facts.
+*/
+void HMHeuristic::extend_tuple(
+    const Tuple &t, const HMOperator &op, Tuple &extension,
+    int first_fact, int c1) {
+    for (int fact = first_fact; fact < num_facts; ++fact) {
+        int var = fact_vars[fact];
+        int value = fact - fact_offsets[var];
+        if (!extension.empty() && fact_vars[extension.back()] == var) {
+            continue;
+        }
+        if ((effect_value[var] != -1 && effect_value[var] != value) ||
+            (precondition_value[var] != -1 && precondition_value[var] != value)) {
+            continue;
+        }
+        bool var_in_t = false;
+        for (int t_fact : t) {
+            if (fact_vars[t_fact] == var) {
+                var_in_t = true;
+                break;
             }
         }
+        if (var_in_t)
+            continue;
+
+        extension.push_back(fact);
+        Tuple pre(op.preconditions);
+        for (int new_fact : extension) {
+            if (precondition_value[fact_vars[new_fact]] == -1) {
+                is_new_fact[new_fact] = true;
+                pre.push_back(new_fact);
+            }
+        }
+        int c2 = c1;
+        if (pre.size() > op.preconditions.size()) {
+            sort(pre.begin(), pre.end());
+            collect_subtuple_ranks(pre, scratch_ranks, true);
+            c2 = max(c2, eval(scratch_ranks));
+        }
+        for (int new_fact : extension)
+            is_new_fact[new_fact] = false;
+
+        if (c2 != numeric_limits<int>::max()) {
+            Tuple tuple(t);
+            tuple.insert(tuple.end(), extension.begin(), extension.end());
+            sort(tuple.begin(), tuple.end());
+            update_hm_entry(tuple, rank(tuple), c2 + op.cost);
+        }
+        if (static_cast<int>(t.size() + extension.size()) < m)
+            extend_tuple(t, op, extension, fact + 1, c1);
+        extension.pop_back();
     }
 }
 
 
-void HMHeuristic::generate_all_partial_tuples(
-    const Tuple &base_tuple, vector<Tuple> &res) const {
-    Tuple t;
-    generate_all_partial_tuples_aux(base_tuple, t, 0, m, res);
+int HMHeuristic::eval(const vector<int> &ranks) const {
+    int max = 0;
+    for (int r : ranks) {
+        int h = hm_table[r];
+        if (h > max) {
+            max = h;
+        }
+    }
+    return max;
 }
 
 
-void HMHeuristic::generate_all_partial_tuples_aux(
-    const Tuple &base_tuple, const Tuple &t, int index, int sz, vector<Tuple> &res) const {
-    if (sz == 1) {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-        }
-    } else {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-            generate_all_partial_tuples_aux(base_tuple, tuple, i + 1, sz - 1, res);
+void HMHeuristic::update_hm_entry(const Tuple &t, int rank, int val) {
+    if (hm_table[rank] > val) {
+        hm_table[rank] = val;
+        /*
+          A smaller tuple can be part of the extension of any operator's
+          partial effect, larger ones only affect operators that have one
+          of their facts as precondition.
+        */
+        if (static_cast<int>(t.size()) < m)
+            needs_full_pass = true;
+        for (int fact : t) {
+            for (int op_id : precondition_of[fact])
+                enqueue_operator(op_id);
         }
     }
 }
@@ -258,9 +350,28 @@ void HMHeuristic::generate_all_partial_tuples_aux(
 
 void HMHeuristic::dump_table() const {
     if (log.is_at_least_debug()) {
-        for (auto &hm_ent : hm_table) {
-            log << "h(" << hm_ent.first << ") = " << hm_ent.second << endl;
+        Tuple tuple;
+        dump_table_aux(tuple, 0);
+    }
+}
+
+
+void HMHeuristic::dump_table_aux(Tuple &tuple, int first_fact) const {
+    for (int fact = first_fact; fact < num_facts; ++fact) {
+        if (!tuple.empty() && fact_vars[tuple.back()] == fact_vars[fact])
+            continue;
+        tuple.push_back(fact);
+        log << "h(";
+        for (size_t i = 0; i < tuple.size(); ++i) {
+            int var = fact_vars[tuple[i]];
+            if (i > 0)
+                log << ", ";
+            log << FactPair(var, tuple[i] - fact_offsets[var]);
         }
+        log << ") = " << hm_table[rank(tuple)] << endl;
+        if (static_cast<int>(tuple.size()) < m)
+            dump_table_aux(tuple, fact + 1);
+        tuple.pop_back();
     }
 }
 
@@ -3,9 +3,7 @@
 
 #include "../heuristic.h"
 
-#include <algorithm>
-#include <iostream>
-#include <map>
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -17,45 +15,97 @@ namespace hm_heuristic {
 /*
   Haslum's h^m heuristic family ("critical path heuristics").
 
-  This is a very slow implementation and should not be used for
-  speed benchmarks.
+  Tuples are sorted vectors of fact indices with pairwise different
+  variables. The h^m table stores one entry for each tuple of size 1 to m.
+  Tuples are ranked with the combinatorial number system: a tuple
+  f_1 < ... < f_k of size k has rank
+  size_offsets[k] + C(f_1, 1) + ... + C(f_k, k),
+  so the table is a dense array. Ranks of tuples containing two facts of
+  the same variable are never used.
+
+  The table is computed with a worklist of operators. An operator is
+  processed again when an entry containing one of its preconditions
+  changes. Since changes of entries with fewer than m facts can affect
+  any operator (by extending its partial effects), such changes schedule
+  another pass over all operators once the worklist is empty.
 */
 
 class HMHeuristic : public Heuristic {
-    using Tuple = std::vector<FactPair>;
+    using Tuple = std::vector<int>;
+
+    struct HMOperator {
+        int cost;
+        Tuple preconditions;
+        // Ranks of all tuples contained in the precondition.
+        std::vector<int> precondition_ranks;
+        std::vector<Tuple> partial_effects;
+        std::vector<int> partial_effect_ranks;
+        std::vector<FactPair> effects;
+    };
+
     // parameters
     const int m;
     const bool has_cond_effects;
 
-    const Tuple goals;
+    std::vector<int> fact_offsets;
+    std::vector<int> fact_vars;
+    int num_facts;
+
+    // binomials[k][f] = C(f, k) for 1 <= k <= m and 0 <= f < num_facts.
+    std::vector<std::vector<int>> binomials;
+    // size_offsets[k]: rank of the first tuple of size k
+    std::vector<int> size_offsets;
+
+    std::vector<HMOperator> operators;
+    // precondition_of[f]: operators with fact f in their precondition
+    std::vector<std::vector<int>> precondition_of;
+    std::vector<int> goal_ranks;
 
     // h^m table
-    std::map<Tuple, int> hm_table;
-    bool was_updated;
+    std::vector<int> hm_table;
+
+    std::deque<int> worklist;
+    std::vector<bool> in_worklist;
+    bool needs_full_pass;
+
+    // Scratch space used while extending partial effects.
+    std::vector<int> precondition_value;
+    std::vector<int> effect_value;
+    std::vector<bool> is_new_fact;
+    std::vector<int> scratch_ranks;
+
+    int get_fact_id(const FactPair &fact) const {
+        return fact_offsets[fact.var] + fact.value;
+    }
+
+    void compute_table_size();
+    int rank(const Tuple &t) const;
+    Tuple get_tuple(const std::vector<FactPair> &facts) const;
+    void collect_subtuple_ranks(
+        const Tuple &base, std::vector<int> &ranks,
+        bool only_with_new_facts = false) const;
+    void collect_subtuple_ranks_aux(
+        const Tuple &base, std::vector<int> &ranks, bool only_with_new_facts,
+        int index, int size, int last_var, int partial_rank,
+        bool has_new_fact) const;
+    void collect_partial_tuples(
+        const Tuple &base, Tuple &tuple, int index,
+        std::vector<Tuple> &res) const;
+    void build_operators();
 
     // auxiliary methods
-    void init_hm_table(const Tuple &t);
+    void init_hm_table(const State &state);
     void update_hm_table();
-    int eval(const Tuple &t) const;
-    int update_hm_entry(const Tuple &t, int val);
-    void extend_tuple(const Tuple &t, const OperatorProxy &op);
-
-    int check_tuple_in_tuple(const Tuple &tuple, const Tuple &big_tuple) const;
-
-    int get_operator_pre_value(const OperatorProxy &op, int var) const;
-    Tuple get_operator_pre(const OperatorProxy &op) const;
-    Tuple get_operator_eff(const OperatorProxy &op) const;
-    bool contradict_effect_of(const OperatorProxy &op, int var, int val) const;
-
-    void generate_all_tuples();
-    void generate_all_tuples_aux(int var, int sz, const Tuple &base);
-
-    void generate_all_partial_tuples(const Tuple &base_tuple,
-                                     std::vector<Tuple> &res) const;
-    void generate_all_partial_tuples_aux(const Tuple &base_tuple, const Tuple &t, int index,
-                                         int sz, std::vector<Tuple> &res) const;
+    void process_operator(int op_id);
+    void extend_tuple(
+        const Tuple &t, const HMOperator &op, Tuple &extension,
+        int first_fact, int c1);
+    int eval(const std::vector<int> &ranks) const;
+    void update_hm_entry(const Tuple &t, int rank, int val);
+    void enqueue_operator(int op_id);
 
     void dump_table() const;
+    void dump_table_aux(Tuple &tuple, int first_fact) const;
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
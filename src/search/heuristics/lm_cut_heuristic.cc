@@ -9,23 +9,191 @@
 #include "../utils/logging.h"
 #include "../utils/memory.h"
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 
 using namespace std;
 
 namespace lm_cut_heuristic {
 LandmarkCutHeuristic::LandmarkCutHeuristic(
-    const shared_ptr<AbstractTask> &transform, bool cache_estimates,
-    const string &description, utils::Verbosity verbosity)
+    bool incremental, const shared_ptr<AbstractTask> &transform,
+    bool cache_estimates, const string &description,
+    utils::Verbosity verbosity)
     : Heuristic(transform, cache_estimates, description, verbosity),
-      landmark_generator(utils::make_unique_ptr<LandmarkCutLandmarks>(task_proxy)) {
+      landmark_generator(utils::make_unique_ptr<LandmarkCutLandmarks>(task_proxy)),
+      incremental(incremental),
+      num_released_ints(0),
+      record_ids(-1),
+      expanded_record_id(-1),
+      num_parent_landmarks(0),
+      num_reused_landmarks(0) {
     if (log.is_at_least_normal()) {
         log << "Initializing landmark cut heuristic..." << endl;
     }
 }
 
+LandmarkCutHeuristic::~LandmarkCutHeuristic() {
+    if (incremental && log.is_at_least_normal()) {
+        double reuse_rate = num_parent_landmarks
+            ? static_cast<double>(num_reused_landmarks) / num_parent_landmarks
+            : 0.0;
+        log << "LM-cut reused landmarks: " << num_reused_landmarks
+            << " of " << num_parent_landmarks << " parent landmarks ("
+            << reuse_rate * 100 << "%)" << endl;
+    }
+}
+
+void LandmarkCutHeuristic::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
+    if (incremental)
+        evals.insert(this);
+}
+
+int LandmarkCutHeuristic::get_record_id(const State &state) {
+    int record_id = record_ids[state];
+    if (record_id == -1)
+        return -1;
+    const LandmarkRecord &record = records[record_id];
+    if (record.offset == -1 || record.registry != state.get_registry() ||
+        record.state_id != state.get_id())
+        return -1;
+    return record_id;
+}
+
+int LandmarkCutHeuristic::store_record(
+    const State &state, const vector<int> &landmarks) {
+    int record_id;
+    LandmarkRecord record = {
+        static_cast<int64_t>(landmark_data.size()), state.get_registry(),
+        state.get_id()};
+    if (free_record_ids.empty()) {
+        record_id = records.size();
+        records.push_back(record);
+    } else {
+        record_id = free_record_ids.back();
+        free_record_ids.pop_back();
+        records[record_id] = record;
+    }
+    landmark_data.push_back(record_id);
+    landmark_data.push_back(landmarks.size());
+    landmark_data.insert(landmark_data.end(), landmarks.begin(), landmarks.end());
+    record_ids[state] = record_id;
+    return record_id;
+}
+
+void LandmarkCutHeuristic::release_record(int record_id) {
+    LandmarkRecord &record = records[record_id];
+    assert(record.offset != -1);
+    landmark_data[record.offset] = -1;
+    num_released_ints += 2 + landmark_data[record.offset + 1];
+    record.offset = -1;
+    free_record_ids.push_back(record_id);
+    if (record_id == expanded_record_id)
+        expanded_record_id = -1;
+    if (2 * num_released_ints > static_cast<int64_t>(landmark_data.size()))
+        compact_landmark_data();
+}
+
+void LandmarkCutHeuristic::compact_landmark_data() {
+    size_t new_size = 0;
+    for (size_t pos = 0; pos < landmark_data.size();) {
+        int record_id = landmark_data[pos];
+        size_t length = 2 + landmark_data[pos + 1];
+        if (record_id != -1) {
+            records[record_id].offset = new_size;
+            copy(landmark_data.begin() + pos,
+                 landmark_data.begin() + pos + length,
+                 landmark_data.begin() + new_size);
+            new_size += length;
+        }
+        pos += length;
+    }
+    landmark_data.resize(new_size);
+    num_released_ints = 0;
+}
+
+void LandmarkCutHeuristic::notify_state_transition(
+    const State &parent_state, OperatorID op_id, const State &state) {
+    int parent_record_id = get_record_id(parent_state);
+    if (parent_record_id != expanded_record_id) {
+        // The search has moved on from the previously expanded state.
+        if (expanded_record_id != -1)
+            release_record(expanded_record_id);
+        expanded_record_id = parent_record_id;
+    }
+    if (parent_record_id == -1 || state == parent_state ||
+        is_estimate_cached(state))
+        return;
+
+    int record_id = get_record_id(state);
+    if (record_id != -1)
+        release_record(record_id);
+
+    reused_landmarks.clear();
+    int64_t offset = records[parent_record_id].offset;
+    int num_ints = landmark_data[offset + 1];
+    auto parent_landmarks = landmark_data.begin() + offset + 2;
+    int op_index = op_id.get_index();
+    for (int pos = 0; pos < num_ints;) {
+        int size = parent_landmarks[pos + 1];
+        auto begin = parent_landmarks + pos;
+        auto end = begin + 2 + size;
+        ++num_parent_landmarks;
+        if (find(begin + 2, end, op_index) == end) {
+            reused_landmarks.insert(reused_landmarks.end(), begin, end);
+            ++num_reused_landmarks;
+        }
+        pos += 2 + size;
+    }
+    if (!reused_landmarks.empty())
+        store_record(state, reused_landmarks);
+}
+
+int LandmarkCutHeuristic::compute_incremental_heuristic(
+    const State &ancestor_state, const State &state) {
+    reused_landmarks.clear();
+    int record_id = get_record_id(ancestor_state);
+    if (record_id != -1) {
+        int64_t offset = records[record_id].offset;
+        auto begin = landmark_data.begin() + offset + 2;
+        reused_landmarks.assign(begin, begin + landmark_data[offset + 1]);
+        release_record(record_id);
+    }
+    int total_cost = 0;
+    for (size_t pos = 0; pos < reused_landmarks.size();
+         pos += 2 + reused_landmarks[pos + 1]) {
+        total_cost += reused_landmarks[pos];
+    }
+
+    new_landmarks.clear();
+    bool dead_end = landmark_generator->compute_landmarks(
+        state,
+        nullptr,
+        [this, &total_cost](const LandmarkCutLandmarks::Landmark &landmark,
+                            int cut_cost) {
+            total_cost += cut_cost;
+            new_landmarks.push_back(cut_cost);
+            new_landmarks.push_back(landmark.size());
+            new_landmarks.insert(
+                new_landmarks.end(), landmark.begin(), landmark.end());
+        },
+        reused_landmarks);
+    if (dead_end)
+        return DEAD_END;
+
+    reused_landmarks.insert(
+        reused_landmarks.end(), new_landmarks.begin(), new_landmarks.end());
+    if (!reused_landmarks.empty())
+        store_record(ancestor_state, reused_landmarks);
+    return total_cost;
+}
+
 int LandmarkCutHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
+    if (incremental)
+        return compute_incremental_heuristic(ancestor_state, state);
+
     int total_cost = 0;
     bool dead_end = landmark_generator->compute_landmarks(
         state,
@@ -43,6 +211,13 @@ public:
     LandmarkCutHeuristicFeature() : TypedFeature("lmcut") {
         document_title("Landmark-cut heuristic");
 
+        add_option<bool>(
+            "incremental",
+            "reuse the landmarks of the parent state that do not contain the "
+            "applied operator when evaluating a state. This stores the "
+            "landmarks of every evaluated state and only speeds up searches "
+            "that notify evaluators of state transitions (e.g., eager search).",
+            "false");
         add_heuristic_options_to_feature(*this, "lmcut");
 
         document_language_support("action costs", "supported");
@@ -59,6 +234,7 @@ public:
         const plugins::Options &opts,
         const utils::Context &) const override {
         return plugins::make_shared_from_arg_tuples<LandmarkCutHeuristic>(
+            opts.get<bool>("incremental"),
             get_heuristic_arguments_from_options(opts)
             );
     }
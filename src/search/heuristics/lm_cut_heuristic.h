@@ -3,7 +3,11 @@
 
 #include "../heuristic.h"
 
+#include "../per_state_information.h"
+
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace plugins {
 class Options;
@@ -15,12 +19,63 @@ class LandmarkCutLandmarks;
 class LandmarkCutHeuristic : public Heuristic {
     std::unique_ptr<LandmarkCutLandmarks> landmark_generator;
 
+    /*
+      In incremental mode, we store the landmarks of each evaluated state
+      (in the flat encoding of LandmarkCutLandmarks). When a state is
+      generated, the landmarks of its parent that do not contain the
+      applied operator are still landmarks of the state. They seed its
+      evaluation, so that LM-cut only has to find landmarks for the
+      remaining operator costs.
+
+      The landmarks are stored as records in one shared arena. A state's
+      record holds the reusable landmarks of its parent until the state is
+      evaluated, and its own landmarks afterwards until it is expanded. A
+      state counts as expanded once the search moves on to generating the
+      successors of another state. Each record starts with its ID and its
+      length. Released records leave gaps in the arena, which are removed
+      once they make up half of it. Per state, we only store a record ID.
+    */
+    struct LandmarkRecord {
+        // Position in landmark_data or -1 if the record is released.
+        int64_t offset;
+        // Owner of the record, for detecting outdated record IDs.
+        const StateRegistry *registry;
+        StateID state_id;
+    };
+
+    bool incremental;
+    std::vector<int> landmark_data;
+    std::vector<LandmarkRecord> records;
+    std::vector<int> free_record_ids;
+    int64_t num_released_ints;
+    PerStateInformation<int> record_ids;
+    // Record of the state whose successors are currently generated.
+    int expanded_record_id;
+    std::vector<int> reused_landmarks;
+    std::vector<int> new_landmarks;
+    int64_t num_parent_landmarks;
+    int64_t num_reused_landmarks;
+
+    int get_record_id(const State &state);
+    int store_record(const State &state, const std::vector<int> &landmarks);
+    void release_record(int record_id);
+    void compact_landmark_data();
+    int compute_incremental_heuristic(
+        const State &ancestor_state, const State &state);
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     LandmarkCutHeuristic(
+        bool incremental,
         const std::shared_ptr<AbstractTask> &transform,
         bool cache_estimates, const std::string &description,
         utils::Verbosity verbosity);
+    virtual ~LandmarkCutHeuristic() override;
+
+    virtual void get_path_dependent_evaluators(
+        std::set<Evaluator *> &evals) override;
+    virtual void notify_state_transition(
+        const State &parent_state, OperatorID op_id,
+        const State &state) override;
 };
 }
 
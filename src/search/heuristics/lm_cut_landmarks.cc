@@ -15,14 +15,20 @@ LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy) {
     task_properties::verify_no_conditional_effects(task_proxy);
 
     // Build propositions.
-    num_propositions = 2; // artificial goal and artificial precondition
+    int num_facts = 0;
     VariablesProxy variables = task_proxy.get_variables();
-    propositions.resize(variables.size());
-    for (FactProxy fact : variables.get_facts()) {
-        int var_id = fact.get_variable().get_id();
-        propositions[var_id].push_back(RelaxedProposition());
-        ++num_propositions;
+    proposition_offsets.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        proposition_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
     }
+    // The artificial goal and precondition come after the facts.
+    artificial_precondition = num_facts;
+    artificial_goal = num_facts + 1;
+    int num_propositions = num_facts + 2;
+    propositions.resize(num_propositions);
+    prop_status.resize(num_propositions, UNREACHED);
+    prop_h_max_cost.resize(num_propositions, 0);
 
     // Build relaxed operators for operators and axioms.
     for (OperatorProxy op : task_proxy.get_operators())
@@ -35,80 +41,92 @@ LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy) {
        unary operators hurts. */
 
     // Build artificial goal proposition and operator.
-    vector<RelaxedProposition *> goal_op_pre, goal_op_eff;
+    vector<PropID> goal_op_pre, goal_op_eff;
     for (FactProxy goal : task_proxy.get_goals()) {
-        goal_op_pre.push_back(get_proposition(goal));
+        goal_op_pre.push_back(get_prop_id(goal));
     }
-    goal_op_eff.push_back(&artificial_goal);
+    goal_op_eff.push_back(artificial_goal);
     /* Use the invalid operator ID -1 so accessing
        the artificial operator will generate an error. */
     add_relaxed_operator(move(goal_op_pre), move(goal_op_eff), -1, 0);
 
     // Cross-reference relaxed operators.
-    for (RelaxedOperator &op : relaxed_operators) {
-        for (RelaxedProposition *pre : op.preconditions)
-            pre->precondition_of.push_back(&op);
-        for (RelaxedProposition *eff : op.effects)
-            eff->effect_of.push_back(&op);
+    vector<vector<OpID>> precondition_of(num_propositions);
+    vector<vector<OpID>> effect_of(num_propositions);
+    for (OpID op_id = 0; op_id < static_cast<OpID>(relaxed_operators.size()); ++op_id) {
+        for (PropID pre : get_preconditions(op_id))
+            precondition_of[pre].push_back(op_id);
+        for (PropID eff : get_effects(op_id))
+            effect_of[eff].push_back(op_id);
     }
+    for (PropID prop_id = 0; prop_id < num_propositions; ++prop_id) {
+        RelaxedProposition &prop = propositions[prop_id];
+        prop.num_precondition_of = precondition_of[prop_id].size();
+        prop.precondition_of =
+            proposition_operators_pool.append(precondition_of[prop_id]);
+        prop.num_effect_of = effect_of[prop_id].size();
+        prop.effect_of = proposition_operators_pool.append(effect_of[prop_id]);
+    }
+
+    int num_operators = relaxed_operators.size();
+    op_cost.resize(num_operators, -1);
+    op_unsatisfied_preconditions.resize(num_operators, -1);
+    op_h_max_supporter_cost.resize(num_operators, -1);
+    op_h_max_supporter.resize(num_operators, NO_PROP);
 }
 
 void LandmarkCutLandmarks::build_relaxed_operator(const OperatorProxy &op) {
-    vector<RelaxedProposition *> precondition;
-    vector<RelaxedProposition *> effects;
+    vector<PropID> precondition;
+    vector<PropID> effects;
     for (FactProxy pre : op.get_preconditions()) {
-        precondition.push_back(get_proposition(pre));
+        precondition.push_back(get_prop_id(pre));
     }
     for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(get_proposition(eff.get_fact()));
+        effects.push_back(get_prop_id(eff.get_fact()));
     }
     add_relaxed_operator(
         move(precondition), move(effects), op.get_id(), op.get_cost());
 }
 
 void LandmarkCutLandmarks::add_relaxed_operator(
-    vector<RelaxedProposition *> &&precondition,
-    vector<RelaxedProposition *> &&effects,
+    vector<PropID> &&precondition,
+    vector<PropID> &&effects,
     int op_id, int base_cost) {
-    RelaxedOperator relaxed_op(
-        move(precondition), move(effects), op_id, base_cost);
-    if (relaxed_op.preconditions.empty())
-        relaxed_op.preconditions.push_back(&artificial_precondition);
-    relaxed_operators.push_back(relaxed_op);
+    if (precondition.empty())
+        precondition.push_back(artificial_precondition);
+    array_pool::ArrayPoolIndex precondition_index =
+        operator_propositions_pool.append(precondition);
+    array_pool::ArrayPoolIndex effects_index =
+        operator_propositions_pool.append(effects);
+    relaxed_operators.emplace_back(
+        precondition.size(), precondition_index,
+        effects.size(), effects_index, op_id, base_cost);
 }
 
-RelaxedProposition *LandmarkCutLandmarks::get_proposition(
-    const FactProxy &fact) {
-    int var_id = fact.get_variable().get_id();
-    int val = fact.get_value();
-    return &propositions[var_id][val];
+PropID LandmarkCutLandmarks::get_prop_id(const FactProxy &fact) const {
+    return proposition_offsets[fact.get_variable().get_id()] + fact.get_value();
 }
 
 // heuristic computation
 void LandmarkCutLandmarks::setup_exploration_queue() {
     priority_queue.clear();
 
-    for (auto &var_props : propositions) {
-        for (RelaxedProposition &prop : var_props) {
-            prop.status = UNREACHED;
-        }
-    }
-
-    artificial_goal.status = UNREACHED;
-    artificial_precondition.status = UNREACHED;
+    fill(prop_status.begin(), prop_status.end(), UNREACHED);
 
-    for (RelaxedOperator &op : relaxed_operators) {
-        op.unsatisfied_preconditions = op.preconditions.size();
-        op.h_max_supporter = nullptr;
-        op.h_max_supporter_cost = numeric_limits<int>::max();
+    for (OpID op_id = 0; op_id < static_cast<OpID>(relaxed_operators.size()); ++op_id) {
+        op_unsatisfied_preconditions[op_id] =
+            relaxed_operators[op_id].num_preconditions;
     }
+    fill(op_h_max_supporter.begin(), op_h_max_supporter.end(), NO_PROP);
+    fill(op_h_max_supporter_cost.begin(), op_h_max_supporter_cost.end(),
+         numeric_limits<int>::max());
 }
 
 void LandmarkCutLandmarks::setup_exploration_queue_state(const State &state) {
     for (FactProxy init_fact : state) {
-        enqueue_if_necessary(get_proposition(init_fact), 0);
+        enqueue_if_necessary(get_prop_id(init_fact), 0);
     }
-    enqueue_if_necessary(&artificial_precondition, 0);
+    enqueue_if_necessary(artificial_precondition, 0);
 }
 
 void LandmarkCutLandmarks::first_exploration(const State &state) {
@@ -116,23 +134,23 @@ void LandmarkCutLandmarks::first_exploration(const State &state) {
     setup_exploration_queue();
     setup_exploration_queue_state(state);
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, PropID> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        PropID prop = top_pair.second;
+        int prop_cost = prop_h_max_cost[prop];
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            --relaxed_op->unsatisfied_preconditions;
-            assert(relaxed_op->unsatisfied_preconditions >= 0);
-            if (relaxed_op->unsatisfied_preconditions == 0) {
-                relaxed_op->h_max_supporter = prop;
-                relaxed_op->h_max_supporter_cost = prop_cost;
-                int target_cost = prop_cost + relaxed_op->cost;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
+        for (OpID relaxed_op : get_precondition_of(prop)) {
+            int &unsatisfied_preconditions =
+                op_unsatisfied_preconditions[relaxed_op];
+            --unsatisfied_preconditions;
+            assert(unsatisfied_preconditions >= 0);
+            if (unsatisfied_preconditions == 0) {
+                op_h_max_supporter[relaxed_op] = prop;
+                op_h_max_supporter_cost[relaxed_op] = prop_cost;
+                int target_cost = prop_cost + op_cost[relaxed_op];
+                for (PropID effect : get_effects(relaxed_op)) {
                     enqueue_if_necessary(effect, target_cost);
                 }
             }
@@ -140,41 +158,38 @@ void LandmarkCutLandmarks::first_exploration(const State &state) {
     }
 }
 
-void LandmarkCutLandmarks::first_exploration_incremental(
-    vector<RelaxedOperator *> &cut) {
+void LandmarkCutLandmarks::first_exploration_incremental(vector<OpID> &cut) {
     assert(priority_queue.empty());
     /* We pretend that this queue has had as many pushes already as we
        have propositions to avoid switching from bucket-based to
        heap-based too aggressively. This should prevent ever switching
        to heap-based in problems where action costs are at most 1.
     */
-    priority_queue.add_virtual_pushes(num_propositions);
-    for (RelaxedOperator *relaxed_op : cut) {
-        int cost = relaxed_op->h_max_supporter_cost + relaxed_op->cost;
-        for (RelaxedProposition *effect : relaxed_op->effects)
+    priority_queue.add_virtual_pushes(propositions.size());
+    for (OpID relaxed_op : cut) {
+        int cost = op_h_max_supporter_cost[relaxed_op] + op_cost[relaxed_op];
+        for (PropID effect : get_effects(relaxed_op))
             enqueue_if_necessary(effect, cost);
     }
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, PropID> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        PropID prop = top_pair.second;
+        int prop_cost = prop_h_max_cost[prop];
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
-                int old_supp_cost = relaxed_op->h_max_supporter_cost;
+        for (OpID relaxed_op : get_precondition_of(prop)) {
+            if (op_h_max_supporter[relaxed_op] == prop) {
+                int old_supp_cost = op_h_max_supporter_cost[relaxed_op];
                 if (old_supp_cost > prop_cost) {
-                    relaxed_op->update_h_max_supporter();
-                    int new_supp_cost = relaxed_op->h_max_supporter_cost;
+                    update_h_max_supporter(relaxed_op);
+                    int new_supp_cost = op_h_max_supporter_cost[relaxed_op];
                     if (new_supp_cost != old_supp_cost) {
                         // This operator has become cheaper.
                         assert(new_supp_cost < old_supp_cost);
-                        int target_cost = new_supp_cost + relaxed_op->cost;
-                        for (RelaxedProposition *effect : relaxed_op->effects)
+                        int target_cost = new_supp_cost + op_cost[relaxed_op];
+                        for (PropID effect : get_effects(relaxed_op))
                             enqueue_if_necessary(effect, target_cost);
                     }
                 }
@@ -184,41 +199,39 @@ void LandmarkCutLandmarks::first_exploration_incremental(
 }
 
 void LandmarkCutLandmarks::second_exploration(
-    const State &state, vector<RelaxedProposition *> &second_exploration_queue,
-    vector<RelaxedOperator *> &cut) {
+    const State &state, vector<PropID> &second_exploration_queue,
+    vector<OpID> &cut) {
     assert(second_exploration_queue.empty());
     assert(cut.empty());
 
-    artificial_precondition.status = BEFORE_GOAL_ZONE;
-    second_exploration_queue.push_back(&artificial_precondition);
+    prop_status[artificial_precondition] = BEFORE_GOAL_ZONE;
+    second_exploration_queue.push_back(artificial_precondition);
 
     for (FactProxy init_fact : state) {
-        RelaxedProposition *init_prop = get_proposition(init_fact);
-        init_prop->status = BEFORE_GOAL_ZONE;
+        PropID init_prop = get_prop_id(init_fact);
+        prop_status[init_prop] = BEFORE_GOAL_ZONE;
         second_exploration_queue.push_back(init_prop);
     }
 
     while (!second_exploration_queue.empty()) {
-        RelaxedProposition *prop = second_exploration_queue.back();
+        PropID prop = second_exploration_queue.back();
         second_exploration_queue.pop_back();
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
+        for (OpID relaxed_op : get_precondition_of(prop)) {
+            if (op_h_max_supporter[relaxed_op] == prop) {
                 bool reached_goal_zone = false;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    if (effect->status == GOAL_ZONE) {
-                        assert(relaxed_op->cost > 0);
+                for (PropID effect : get_effects(relaxed_op)) {
+                    if (prop_status[effect] == GOAL_ZONE) {
+                        assert(op_cost[relaxed_op] > 0);
                         reached_goal_zone = true;
                         cut.push_back(relaxed_op);
                         break;
                     }
                 }
                 if (!reached_goal_zone) {
-                    for (RelaxedProposition *effect : relaxed_op->effects) {
-                        if (effect->status != BEFORE_GOAL_ZONE) {
-                            assert(effect->status == REACHED);
-                            effect->status = BEFORE_GOAL_ZONE;
+                    for (PropID effect : get_effects(relaxed_op)) {
+                        if (prop_status[effect] != BEFORE_GOAL_ZONE) {
+                            assert(prop_status[effect] == REACHED);
+                            prop_status[effect] = BEFORE_GOAL_ZONE;
                             second_exploration_queue.push_back(effect);
                         }
                     }
@@ -228,16 +241,16 @@ void LandmarkCutLandmarks::second_exploration(
     }
 }
 
-void LandmarkCutLandmarks::mark_goal_plateau(RelaxedProposition *subgoal) {
-    // NOTE: subgoal can be null if we got here via recursion through
+void LandmarkCutLandmarks::mark_goal_plateau(PropID subgoal) {
+    // NOTE: subgoal can be NO_PROP if we got here via recursion through
     // a zero-cost action that is relaxed unreachable. (This can only
     // happen in domains which have zero-cost actions to start with.)
     // For example, this happens in pegsol-strips #01.
-    if (subgoal && subgoal->status != GOAL_ZONE) {
-        subgoal->status = GOAL_ZONE;
-        for (RelaxedOperator *achiever : subgoal->effect_of)
-            if (achiever->cost == 0)
-                mark_goal_plateau(achiever->h_max_supporter);
+    if (subgoal != NO_PROP && prop_status[subgoal] != GOAL_ZONE) {
+        prop_status[subgoal] = GOAL_ZONE;
+        for (OpID achiever : get_effect_of(subgoal))
+            if (op_cost[achiever] == 0)
+                mark_goal_plateau(op_h_max_supporter[achiever]);
     }
 }
 
@@ -246,24 +259,24 @@ void LandmarkCutLandmarks::validate_h_max() const {
     // Using conditional compilation to avoid complaints about unused
     // variables when using NDEBUG. This whole code does nothing useful
     // when assertions are switched off anyway.
-    for (const RelaxedOperator &op : relaxed_operators) {
-        if (op.unsatisfied_preconditions) {
+    for (OpID op_id = 0; op_id < static_cast<OpID>(relaxed_operators.size()); ++op_id) {
+        if (op_unsatisfied_preconditions[op_id]) {
             bool reachable = true;
-            for (RelaxedProposition *pre : op.preconditions) {
-                if (pre->status == UNREACHED) {
+            for (PropID pre : get_preconditions(op_id)) {
+                if (prop_status[pre] == UNREACHED) {
                     reachable = false;
                     break;
                 }
             }
             assert(!reachable);
-            assert(!op.h_max_supporter);
+            assert(op_h_max_supporter[op_id] == NO_PROP);
         } else {
-            assert(op.h_max_supporter);
-            int h_max_cost = op.h_max_supporter_cost;
-            assert(h_max_cost == op.h_max_supporter->h_max_cost);
-            for (RelaxedProposition *pre : op.preconditions) {
-                assert(pre->status != UNREACHED);
-                assert(pre->h_max_cost <= h_max_cost);
+            assert(op_h_max_supporter[op_id] != NO_PROP);
+            int h_max_cost = op_h_max_supporter_cost[op_id];
+            assert(h_max_cost == prop_h_max_cost[op_h_max_supporter[op_id]]);
+            for (PropID pre : get_preconditions(op_id)) {
+                assert(prop_status[pre] != UNREACHED);
+                assert(prop_h_max_cost[pre] <= h_max_cost);
             }
         }
     }
@@ -273,39 +286,61 @@ void LandmarkCutLandmarks::validate_h_max() const {
 bool LandmarkCutLandmarks::compute_landmarks(
     const State &state, const CostCallback &cost_callback,
     const LandmarkCallback &landmark_callback) {
-    for (RelaxedOperator &op : relaxed_operators) {
-        op.cost = op.base_cost;
+    return compute_landmarks(
+        state, cost_callback, landmark_callback, FlatLandmarks());
+}
+
+bool LandmarkCutLandmarks::compute_landmarks(
+    const State &state, const CostCallback &cost_callback,
+    const LandmarkCallback &landmark_callback,
+    const FlatLandmarks &reused_landmarks) {
+    for (OpID op_id = 0; op_id < static_cast<OpID>(relaxed_operators.size()); ++op_id) {
+        op_cost[op_id] = relaxed_operators[op_id].base_cost;
+    }
+    for (size_t pos = 0; pos < reused_landmarks.size();) {
+        int cost = reused_landmarks[pos];
+        int size = reused_landmarks[pos + 1];
+        pos += 2;
+        for (int i = 0; i < size; ++i) {
+            /* Relaxed operators are built in the order of the operators,
+               so the original operator ID is also the index. */
+            OpID op_id = reused_landmarks[pos + i];
+            assert(relaxed_operators[op_id].original_op_id == op_id);
+            op_cost[op_id] -= cost;
+            assert(op_cost[op_id] >= 0);
+        }
+        pos += size;
     }
     // The following three variables could be declared inside the loop
     // ("second_exploration_queue" even inside second_exploration),
     // but having them here saves reallocations and hence provides a
     // measurable speed boost.
-    vector<RelaxedOperator *> cut;
+    vector<OpID> cut;
     Landmark landmark;
-    vector<RelaxedProposition *> second_exploration_queue;
+    vector<PropID> second_exploration_queue;
     first_exploration(state);
     // validate_h_max();  // too expensive to use even in regular debug mode
-    if (artificial_goal.status == UNREACHED)
+    if (prop_status[artificial_goal] == UNREACHED)
         return true;
 
-    while (artificial_goal.h_max_cost != 0) {
-        mark_goal_plateau(&artificial_goal);
+    while (prop_h_max_cost[artificial_goal] != 0) {
+        mark_goal_plateau(artificial_goal);
         assert(cut.empty());
         second_exploration(state, second_exploration_queue, cut);
         assert(!cut.empty());
         int cut_cost = numeric_limits<int>::max();
-        for (RelaxedOperator *op : cut)
-            cut_cost = min(cut_cost, op->cost);
-        for (RelaxedOperator *op : cut)
-            op->cost -= cut_cost;
+        for (OpID op_id : cut)
+            cut_cost = min(cut_cost, op_cost[op_id]);
+        for (OpID op_id : cut)
+            op_cost[op_id] -= cut_cost;
 
         if (cost_callback) {
             cost_callback(cut_cost);
         }
         if (landmark_callback) {
             landmark.clear();
-            for (RelaxedOperator *op : cut) {
-                landmark.push_back(op->original_op_id);
+            for (OpID op_id : cut) {
+                landmark.push_back(relaxed_operators[op_id].original_op_id);
             }
             landmark_callback(landmark, cut_cost);
         }
@@ -320,14 +355,10 @@ bool LandmarkCutLandmarks::compute_landmarks(
           or something based on total_cost, so that we don't need a per-round
           reinitialization.
         */
-        for (auto &var_props : propositions) {
-            for (RelaxedProposition &prop : var_props) {
-                if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
-                    prop.status = REACHED;
-            }
+        for (PropositionStatus &status : prop_status) {
+            if (status == GOAL_ZONE || status == BEFORE_GOAL_ZONE)
+                status = REACHED;
         }
-        artificial_goal.status = REACHED;
-        artificial_precondition.status = REACHED;
     }
     return false;
 }
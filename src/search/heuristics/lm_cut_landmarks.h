@@ -1,91 +1,150 @@
 #ifndef HEURISTICS_LM_CUT_LANDMARKS_H
 #define HEURISTICS_LM_CUT_LANDMARKS_H
 
+#include "array_pool.h"
+
 #include "../task_proxy.h"
 
 #include "../algorithms/priority_queues.h"
 
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <vector>
 
 namespace lm_cut_heuristic {
 // TODO: Fix duplication with the other relaxation heuristics.
-struct RelaxedProposition;
+using PropID = int;
+using OpID = int;
+
+const PropID NO_PROP = -1;
 
-enum PropositionStatus {
+enum PropositionStatus : std::uint8_t {
     UNREACHED = 0,
     REACHED = 1,
     GOAL_ZONE = 2,
     BEFORE_GOAL_ZONE = 3
 };
 
+/*
+  The structure of the relaxed task is stored like in the relaxation
+  heuristics: operators and propositions refer to each other by index and
+  their lists live in array pools. The values that change during the
+  explorations are kept in separate arrays (see LandmarkCutLandmarks).
+*/
 struct RelaxedOperator {
+    int num_preconditions;
+    array_pool::ArrayPoolIndex preconditions;
+    int num_effects;
+    array_pool::ArrayPoolIndex effects;
     int original_op_id;
-    std::vector<RelaxedProposition *> preconditions;
-    std::vector<RelaxedProposition *> effects;
     int base_cost; // 0 for axioms, 1 for regular operators
 
-    int cost;
-    int unsatisfied_preconditions;
-    int h_max_supporter_cost; // h_max_cost of h_max_supporter
-    RelaxedProposition *h_max_supporter;
-    RelaxedOperator(std::vector<RelaxedProposition *> &&pre,
-                    std::vector<RelaxedProposition *> &&eff,
+    RelaxedOperator(int num_preconditions,
+                    array_pool::ArrayPoolIndex preconditions,
+                    int num_effects, array_pool::ArrayPoolIndex effects,
                     int op_id, int base)
-        : original_op_id(op_id), preconditions(pre), effects(eff), base_cost(base),
-          cost(-1), unsatisfied_preconditions(-1), h_max_supporter_cost(-1),
-          h_max_supporter(nullptr) {
+        : num_preconditions(num_preconditions), preconditions(preconditions),
+          num_effects(num_effects), effects(effects),
+          original_op_id(op_id), base_cost(base) {
     }
-
-    inline void update_h_max_supporter();
 };
 
 struct RelaxedProposition {
-    std::vector<RelaxedOperator *> precondition_of;
-    std::vector<RelaxedOperator *> effect_of;
+    int num_precondition_of;
+    array_pool::ArrayPoolIndex precondition_of;
+    int num_effect_of;
+    array_pool::ArrayPoolIndex effect_of;
 
-    PropositionStatus status;
-    int h_max_cost;
+    RelaxedProposition()
+        : num_precondition_of(0), num_effect_of(0) {
+    }
 };
 
 class LandmarkCutLandmarks {
     std::vector<RelaxedOperator> relaxed_operators;
-    std::vector<std::vector<RelaxedProposition>> propositions;
-    RelaxedProposition artificial_precondition;
-    RelaxedProposition artificial_goal;
-    int num_propositions;
-    priority_queues::AdaptiveQueue<RelaxedProposition *> priority_queue;
+    std::vector<RelaxedProposition> propositions;
+    // proposition_offsets[var]: first PropID related to variable var
+    std::vector<PropID> proposition_offsets;
+    PropID artificial_precondition;
+    PropID artificial_goal;
+
+    array_pool::ArrayPool operator_propositions_pool;
+    array_pool::ArrayPool proposition_operators_pool;
+
+    // Per-operator values that change during the explorations.
+    std::vector<int> op_cost;
+    std::vector<int> op_unsatisfied_preconditions;
+    std::vector<int> op_h_max_supporter_cost; // h_max_cost of h_max_supporter
+    std::vector<PropID> op_h_max_supporter;
+
+    // Per-proposition values that change during the explorations.
+    std::vector<PropositionStatus> prop_status;
+    std::vector<int> prop_h_max_cost;
+
+    priority_queues::AdaptiveQueue<PropID> priority_queue;
 
     void build_relaxed_operator(const OperatorProxy &op);
-    void add_relaxed_operator(std::vector<RelaxedProposition *> &&precondition,
-                              std::vector<RelaxedProposition *> &&effects,
+    void add_relaxed_operator(std::vector<PropID> &&precondition,
+                              std::vector<PropID> &&effects,
                               int op_id, int base_cost);
-    RelaxedProposition *get_proposition(const FactProxy &fact);
+    PropID get_prop_id(const FactProxy &fact) const;
+
+    array_pool::ArrayPoolSlice get_preconditions(OpID op_id) const {
+        const RelaxedOperator &op = relaxed_operators[op_id];
+        return operator_propositions_pool.get_slice(
+            op.preconditions, op.num_preconditions);
+    }
+
+    array_pool::ArrayPoolSlice get_effects(OpID op_id) const {
+        const RelaxedOperator &op = relaxed_operators[op_id];
+        return operator_propositions_pool.get_slice(
+            op.effects, op.num_effects);
+    }
+
+    array_pool::ArrayPoolSlice get_precondition_of(PropID prop_id) const {
+        const RelaxedProposition &prop = propositions[prop_id];
+        return proposition_operators_pool.get_slice(
+            prop.precondition_of, prop.num_precondition_of);
+    }
+
+    array_pool::ArrayPoolSlice get_effect_of(PropID prop_id) const {
+        const RelaxedProposition &prop = propositions[prop_id];
+        return proposition_operators_pool.get_slice(
+            prop.effect_of, prop.num_effect_of);
+    }
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void first_exploration(const State &state);
-    void first_exploration_incremental(std::vector<RelaxedOperator *> &cut);
+    void first_exploration_incremental(std::vector<OpID> &cut);
     void second_exploration(const State &state,
-                            std::vector<RelaxedProposition *> &second_exploration_queue,
-                            std::vector<RelaxedOperator *> &cut);
+                            std::vector<PropID> &second_exploration_queue,
+                            std::vector<OpID> &cut);
 
-    void enqueue_if_necessary(RelaxedProposition *prop, int cost) {
+    void enqueue_if_necessary(PropID prop_id, int cost) {
         assert(cost >= 0);
-        if (prop->status == UNREACHED || prop->h_max_cost > cost) {
-            prop->status = REACHED;
-            prop->h_max_cost = cost;
-            priority_queue.push(cost, prop);
+        if (prop_status[prop_id] == UNREACHED || prop_h_max_cost[prop_id] > cost) {
+            prop_status[prop_id] = REACHED;
+            prop_h_max_cost[prop_id] = cost;
+            priority_queue.push(cost, prop_id);
         }
     }
 
-    void mark_goal_plateau(RelaxedProposition *subgoal);
+    inline void update_h_max_supporter(OpID op_id);
+    void mark_goal_plateau(PropID subgoal);
     void validate_h_max() const;
 public:
     using Landmark = std::vector<int>;
     using CostCallback = std::function<void (int)>;
     using LandmarkCallback = std::function<void (const Landmark &, int)>;
+    /*
+      Compact encoding of a sequence of landmarks in a single vector: for
+      each landmark, its cost, its number of operators and the operator
+      indices.
+    */
+    using FlatLandmarks = std::vector<int>;
 
     LandmarkCutLandmarks(const TaskProxy &task_proxy);
 
@@ -104,14 +163,28 @@ public:
     */
     bool compute_landmarks(const State &state, const CostCallback &cost_callback,
                            const LandmarkCallback &landmark_callback);
+
+    /*
+      Like compute_landmarks above, but starts from the operator costs that
+      remain after subtracting the costs of the given landmarks. These must
+      be landmarks of the state whose costs form a cost partitioning, for
+      example the landmarks of a parent state that do not contain the
+      operator leading to the state. Only newly discovered landmarks are
+      reported.
+    */
+    bool compute_landmarks(const State &state, const CostCallback &cost_callback,
+                           const LandmarkCallback &landmark_callback,
+                           const FlatLandmarks &reused_landmarks);
 };
 
-inline void RelaxedOperator::update_h_max_supporter() {
-    assert(!unsatisfied_preconditions);
-    for (size_t i = 0; i < preconditions.size(); ++i)
-        if (preconditions[i]->h_max_cost > h_max_supporter->h_max_cost)
-            h_max_supporter = preconditions[i];
-    h_max_supporter_cost = h_max_supporter->h_max_cost;
+inline void LandmarkCutLandmarks::update_h_max_supporter(OpID op_id) {
+    assert(!op_unsatisfied_preconditions[op_id]);
+    PropID supporter = op_h_max_supporter[op_id];
+    for (PropID pre : get_preconditions(op_id))
+        if (prop_h_max_cost[pre] > prop_h_max_cost[supporter])
+            supporter = pre;
+    op_h_max_supporter[op_id] = supporter;
+    op_h_max_supporter_cost[op_id] = prop_h_max_cost[supporter];
 }
 }
 
@@ -3,7 +3,9 @@
 #include "../plugins/plugin.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 #include <vector>
 
 using namespace std;
@@ -28,10 +30,26 @@ HSPMaxHeuristic::HSPMaxHeuristic(
     const string &description, utils::Verbosity verbosity)
     : RelaxationHeuristic(
           axioms, transform, cache_estimates, description,
-          verbosity) {
+          verbosity),
+      use_layered_exploration(
+          all_of(unary_operators.begin(), unary_operators.end(),
+                 [](const UnaryOperator &op) {return op.base_cost == 1;})) {
     if (log.is_at_least_normal()) {
         log << "Initializing HSP max heuristic..." << endl;
     }
+    if (use_layered_exploration) {
+        num_preconditions.reserve(unary_operators.size());
+        for (size_t op_id = 0; op_id < unary_operators.size(); ++op_id) {
+            int num_pre = unary_operators[op_id].num_preconditions;
+            num_preconditions.push_back(num_pre);
+            if (num_pre == 0)
+                operators_without_preconditions.push_back(op_id);
+        }
+        reached.resize((propositions.size() + 63) / 64);
+        if (log.is_at_least_normal()) {
+            log << "Unit-cost task: using layered exploration." << endl;
+        }
+    }
 }
 
 // heuristic computation
@@ -85,12 +103,48 @@ void HSPMaxHeuristic::relaxed_exploration() {
     }
 }
 
+void HSPMaxHeuristic::layered_exploration(const State &state) {
+    for (Proposition &prop : propositions)
+        prop.cost = -1;
+    fill(reached.begin(), reached.end(), 0);
+    unsatisfied_preconditions = num_preconditions;
+
+    current_layer.clear();
+    next_layer.clear();
+    for (FactProxy fact : state)
+        reach_in_layer(get_prop_id(fact), 0, current_layer);
+    for (OpID op_id : operators_without_preconditions)
+        reach_in_layer(get_operator(op_id)->effect, 1, next_layer);
+
+    int unsolved_goals = goal_propositions.size();
+    for (int layer = 0; !current_layer.empty(); ++layer) {
+        for (PropID prop_id : current_layer) {
+            const Proposition *prop = get_proposition(prop_id);
+            if (prop->is_goal && --unsolved_goals == 0)
+                return;
+            for (OpID op_id : precondition_of_pool.get_slice(
+                     prop->precondition_of, prop->num_precondition_occurences)) {
+                assert(unsatisfied_preconditions[op_id] > 0);
+                if (--unsatisfied_preconditions[op_id] == 0)
+                    reach_in_layer(get_operator(op_id)->effect, layer + 1,
+                                   next_layer);
+            }
+        }
+        current_layer.swap(next_layer);
+        next_layer.clear();
+    }
+}
+
 int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
 
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    if (use_layered_exploration) {
+        layered_exploration(state);
+    } else {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+    }
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
@@ -103,6 +157,12 @@ int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
     return total_cost;
 }
 
+void HSPMaxHeuristic::compute_heuristic_batch(
+    const vector<State> &ancestor_states, vector<int> &values) {
+    compute_relaxed_batch(
+        ancestor_states, values, false, numeric_limits<int>::max());
+}
+
 class HSPMaxHeuristicFeature
     : public plugins::TypedFeature<Evaluator, HSPMaxHeuristic> {
 public:
@@ -6,6 +6,8 @@
 #include "../algorithms/priority_queues.h"
 
 #include <cassert>
+#include <cstdint>
+#include <vector>
 
 namespace max_heuristic {
 using relaxation_heuristic::PropID;
@@ -17,9 +19,35 @@ using relaxation_heuristic::UnaryOperator;
 class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     priority_queues::AdaptiveQueue<PropID> queue;
 
+    /*
+      If all unary operators cost 1, h^max values are BFS layers of the
+      relaxed planning graph. We then compute them layer by layer without
+      a priority queue, keeping the reached propositions in a bitset and
+      the unsatisfied precondition counters in a dense array.
+    */
+    bool use_layered_exploration;
+    std::vector<int> num_preconditions;
+    std::vector<int> unsatisfied_preconditions;
+    std::vector<OpID> operators_without_preconditions;
+    std::vector<std::uint64_t> reached;
+    std::vector<PropID> current_layer;
+    std::vector<PropID> next_layer;
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
+    void layered_exploration(const State &state);
+
+    void reach_in_layer(PropID prop_id, int layer,
+                        std::vector<PropID> &layer_props) {
+        std::uint64_t &word = reached[prop_id / 64];
+        std::uint64_t bit = std::uint64_t(1) << (prop_id % 64);
+        if (!(word & bit)) {
+            word |= bit;
+            get_proposition(prop_id)->cost = layer;
+            layer_props.push_back(prop_id);
+        }
+    }
 
     void enqueue_if_necessary(PropID prop_id, int cost) {
         assert(cost >= 0);
@@ -32,6 +60,9 @@ class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     }
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual void compute_heuristic_batch(
+        const std::vector<State> &ancestor_states,
+        std::vector<int> &values) override;
 public:
     HSPMaxHeuristic(
         tasks::AxiomHandlingType axioms,
@@ -56,7 +56,8 @@ RelaxationHeuristic::RelaxationHeuristic(
     const string &description, utils::Verbosity verbosity)
     : Heuristic(tasks::get_default_value_axioms_task_if_needed(
                     transform, axioms),
-                cache_estimates, description, verbosity) {
+                cache_estimates, description, verbosity),
+      num_batch_lanes(0) {
     // Build propositions.
     propositions.resize(task_properties::get_num_facts(task_proxy));
 
@@ -116,6 +117,143 @@ bool RelaxationHeuristic::dead_ends_are_reliable() const {
     return !task_properties::has_axioms(task_proxy);
 }
 
+void RelaxationHeuristic::enqueue_in_batch(PropID prop_id, int key) {
+    if (key < batch_queued_keys[prop_id]) {
+        batch_queued_keys[prop_id] = key;
+        batch_queue.push(key, prop_id);
+    }
+}
+
+void RelaxationHeuristic::relax_operator_in_batch(
+    OpID op_id, bool additive, int max_cost, bool &clamped) {
+    const UnaryOperator &op = unary_operators[op_id];
+    int num_lanes = num_batch_lanes;
+    int op_costs[MAX_BATCH_LANES];
+    fill_n(op_costs, num_lanes, 0);
+    for (PropID precond : get_preconditions(op_id)) {
+        const int *precond_costs = &batch_prop_costs[precond * num_lanes];
+        for (int lane = 0; lane < num_lanes; ++lane) {
+            int precond_cost = precond_costs[lane];
+            if (!additive) {
+                // BATCH_UNREACHED is the largest int, so max propagates it.
+                op_costs[lane] = max(op_costs[lane], precond_cost);
+            } else if (precond_cost == BATCH_UNREACHED ||
+                       op_costs[lane] == BATCH_UNREACHED) {
+                op_costs[lane] = BATCH_UNREACHED;
+            } else {
+                op_costs[lane] += precond_cost;
+                if (op_costs[lane] > max_cost) {
+                    op_costs[lane] = max_cost;
+                    clamped = true;
+                }
+            }
+        }
+    }
+
+    int *effect_costs = &batch_prop_costs[op.effect * num_lanes];
+    int min_improved_cost = BATCH_UNREACHED;
+    for (int lane = 0; lane < num_lanes; ++lane) {
+        if (op_costs[lane] == BATCH_UNREACHED)
+            continue;
+        int cost = op_costs[lane] + op.base_cost;
+        if (additive && cost > max_cost) {
+            cost = max_cost;
+            clamped = true;
+        }
+        if (cost < effect_costs[lane]) {
+            effect_costs[lane] = cost;
+            min_improved_cost = min(min_improved_cost, cost);
+        }
+    }
+    if (min_improved_cost != BATCH_UNREACHED)
+        enqueue_in_batch(op.effect, min_improved_cost);
+}
+
+bool RelaxationHeuristic::compute_batch_costs(
+    const vector<State> &states, bool additive, int max_cost) {
+    assert(!states.empty() && states.size() <= MAX_BATCH_LANES);
+    num_batch_lanes = states.size();
+    batch_prop_costs.assign(
+        propositions.size() * num_batch_lanes, BATCH_UNREACHED);
+    batch_queued_keys.assign(propositions.size(), BATCH_UNREACHED);
+    batch_queue.clear();
+
+    for (int lane = 0; lane < num_batch_lanes; ++lane) {
+        for (FactProxy fact : states[lane]) {
+            PropID prop_id = get_prop_id(fact);
+            batch_prop_costs[prop_id * num_batch_lanes + lane] = 0;
+            enqueue_in_batch(prop_id, 0);
+        }
+    }
+
+    bool clamped = false;
+    int num_unary_ops = unary_operators.size();
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        if (unary_operators[op_id].num_preconditions == 0)
+            relax_operator_in_batch(op_id, additive, max_cost, clamped);
+    }
+
+    /*
+      Unlike in the single-state explorations, a proposition can be
+      processed several times because its costs in different lanes may
+      become final at different times. Every improvement of a cost
+      queues the proposition again, so all costs reach their fixpoint.
+    */
+    while (!batch_queue.empty()) {
+        pair<int, PropID> top_pair = batch_queue.pop();
+        PropID prop_id = top_pair.second;
+        if (top_pair.first != batch_queued_keys[prop_id])
+            continue;
+        batch_queued_keys[prop_id] = BATCH_UNREACHED;
+        const Proposition &prop = propositions[prop_id];
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop.precondition_of, prop.num_precondition_occurences))
+            relax_operator_in_batch(op_id, additive, max_cost, clamped);
+    }
+    return clamped;
+}
+
+bool RelaxationHeuristic::compute_relaxed_batch(
+    const vector<State> &ancestor_states, vector<int> &values,
+    bool additive, int max_cost) {
+    values.clear();
+    values.reserve(ancestor_states.size());
+    bool clamped = false;
+    vector<State> states;
+    for (size_t start = 0; start < ancestor_states.size();
+         start += MAX_BATCH_LANES) {
+        size_t end = min(ancestor_states.size(), start + MAX_BATCH_LANES);
+        states.clear();
+        for (size_t i = start; i < end; ++i)
+            states.push_back(convert_ancestor_state(ancestor_states[i]));
+        if (compute_batch_costs(states, additive, max_cost))
+            clamped = true;
+
+        for (int lane = 0; lane < num_batch_lanes; ++lane) {
+            int total_cost = 0;
+            for (PropID goal_id : goal_propositions) {
+                int goal_cost =
+                    batch_prop_costs[goal_id * num_batch_lanes + lane];
+                if (goal_cost == BATCH_UNREACHED) {
+                    total_cost = DEAD_END;
+                    break;
+                }
+                if (!additive) {
+                    total_cost = max(total_cost, goal_cost);
+                } else {
+                    total_cost += goal_cost;
+                    if (total_cost > max_cost) {
+                        total_cost = max_cost;
+                        clamped = true;
+                    }
+                }
+            }
+            values.push_back(total_cost);
+        }
+    }
+    return clamped;
+}
+
 PropID RelaxationHeuristic::get_prop_id(int var, int value) const {
     return proposition_offsets[var] + value;
 }
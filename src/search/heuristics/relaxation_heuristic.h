@@ -5,10 +5,12 @@
 
 #include "../heuristic.h"
 
+#include "../algorithms/priority_queues.h"
 #include "../tasks/default_value_axioms_task.h"
 #include "../utils/collections.h"
 
 #include <cassert>
+#include <limits>
 #include <vector>
 
 class FactProxy;
@@ -61,7 +63,27 @@ class RelaxationHeuristic : public Heuristic {
 
     // proposition_offsets[var_no]: first PropID related to variable var_no
     std::vector<PropID> proposition_offsets;
+
+    /*
+      Cost lanes for batch evaluation: batch_prop_costs holds the costs of
+      proposition p for the states of the batch at positions
+      p * num_batch_lanes, ..., p * num_batch_lanes + num_batch_lanes - 1.
+      batch_queued_keys[p] is the key with which p is currently queued.
+    */
+    int num_batch_lanes;
+    std::vector<int> batch_prop_costs;
+    std::vector<int> batch_queued_keys;
+    priority_queues::AdaptiveQueue<PropID> batch_queue;
+
+    void enqueue_in_batch(PropID prop_id, int key);
+    void relax_operator_in_batch(
+        OpID op_id, bool additive, int max_cost, bool &clamped);
+    bool compute_batch_costs(
+        const std::vector<State> &states, bool additive, int max_cost);
 protected:
+    static constexpr int BATCH_UNREACHED = std::numeric_limits<int>::max();
+    static constexpr int MAX_BATCH_LANES = 16;
+
     std::vector<UnaryOperator> unary_operators;
     std::vector<Proposition> propositions;
     std::vector<PropID> goal_propositions;
@@ -110,6 +132,20 @@ protected:
     const Proposition *get_proposition(int var, int value) const;
     Proposition *get_proposition(int var, int value);
     Proposition *get_proposition(const FactProxy &fact);
+
+    /*
+      Compute h^add (if additive is true) or h^max values for several
+      states. The states are processed in groups of up to MAX_BATCH_LANES,
+      and each proposition has one cost per state of the group, so that
+      resetting the costs and relaxing an operator is done once for the
+      whole group. Costs are propagated with a priority queue until no
+      state's cost improves, which yields the same values as exploring
+      each state on its own. h^add costs are clamped to max_cost.
+      Returns true iff a cost was clamped.
+    */
+    bool compute_relaxed_batch(
+        const std::vector<State> &ancestor_states, std::vector<int> &values,
+        bool additive, int max_cost);
 public:
     RelaxationHeuristic(
         tasks::AxiomHandlingType axioms,
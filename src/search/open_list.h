@@ -8,6 +8,7 @@
 #include <vector>
 
 class StateID;
+struct PlateauStatistics;
 
 
 template<class Entry>
@@ -47,7 +48,12 @@ public:
       do_insertion.
     */
     void insert(EvaluationContext &eval_context, const Entry &entry);
-    virtual std::vector<int> insert(EvaluationContext &eval_context, const Entry &entry, EvaluationContext &parent_eval_context, int d_val);
+    /*
+      Insert an entry using depth-diversified tie-breaking. Only
+      implemented by open lists that support depth diversification;
+      they update their plateau statistics in place.
+    */
+    virtual void insert(EvaluationContext &eval_context, const Entry &entry, EvaluationContext &parent_eval_context, int d_val);
 
     /*
       Remove and return the entry that should be expanded next.
@@ -83,6 +89,12 @@ public:
     */
     virtual void boost_preferred();
 
+    /*
+      Return the statistics collected by depth-diversified insertion, or
+      nullptr if the open list does not collect any.
+    */
+    virtual const PlateauStatistics *get_plateau_statistics() const;
+
     /*
       Add all path-dependent evaluators that this open lists uses (directly or
       indirectly) into the result set.
@@ -92,6 +104,13 @@ public:
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) = 0;
 
+    /*
+      Add all evaluators that this open list uses directly into the result
+      set. Search algorithms use this to evaluate batches of states before
+      inserting them (see Evaluator::compute_batch_results).
+    */
+    virtual void get_evaluators(std::set<Evaluator *> &evals) = 0;
+
     /*
       Accessor method for only_preferred.
 
@@ -154,7 +173,7 @@ void OpenList<Entry>::insert( // original insert
 }
 
 template<class Entry>
-std::vector<int> OpenList<Entry>::insert( // dummy method for all open_list types except div_tiebreaking
+void OpenList<Entry>::insert( // dummy method for all open_list types except div_tiebreaking
         EvaluationContext &eval_context, const Entry &entry, EvaluationContext &parent_eval_context, int d_val) {
     (void)eval_context;
     (void)entry;
@@ -162,7 +181,11 @@ std::vector<int> OpenList<Entry>::insert( // dummy method for all open_list type
     (void)d_val;
     std::cerr << "This is just a dummy method for insert in open_list.h, which should not be called!" <<std::endl;
     exit(-1);
-    return {-1, -1};
+}
+
+template<class Entry>
+const PlateauStatistics *OpenList<Entry>::get_plateau_statistics() const {
+    return nullptr;
 }
 
 template<class Entry>
@@ -5,6 +5,8 @@
 
 #include "../plugins/plugin.h"
 #include "../utils/memory.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
 
 #include <cassert>
 #include <deque>
@@ -12,8 +14,6 @@
 #include <utility>
 #include <vector>
 #include <optional>
-#include <cstdlib>
-#include <ctime>
 #include <iterator>
 
 using namespace std;
@@ -35,6 +35,7 @@ class CriteriaTieBreakingOpenList : public OpenList<Entry> {
     bool allow_unsafe_pruning;
 
     TieBreakingCriteria tiebreaking_criteria;
+    shared_ptr<utils::RandomNumberGenerator> rng;
 
     int dimension() const;
 
@@ -45,12 +46,14 @@ protected:
 public:
     CriteriaTieBreakingOpenList(
         const vector<shared_ptr<Evaluator>> &evals,
-        bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria); // TODO: default enum
+        bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria,
+        int random_seed); // TODO: default enum
 
     virtual Entry remove_min() override;
     virtual bool empty() const override;
     virtual void clear() override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual void get_evaluators(set<Evaluator *> &evals) override;
     virtual bool is_dead_end(
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
@@ -61,11 +64,13 @@ public:
 template<class Entry>
 CriteriaTieBreakingOpenList<Entry>::CriteriaTieBreakingOpenList( // Constructor when criteria is used
     const vector<shared_ptr<Evaluator>> &evals,
-    bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria)
+    bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria,
+    int random_seed)
     : OpenList<Entry>(pref_only),
       size(0), evaluators(evals),
       allow_unsafe_pruning(unsafe_pruning),
-      tiebreaking_criteria(tiebreaking_criteria) {
+      tiebreaking_criteria(tiebreaking_criteria),
+      rng(utils::get_rng(random_seed)) {
 }
 
 template<class Entry>
@@ -90,31 +95,33 @@ Entry CriteriaTieBreakingOpenList<Entry>::remove_min() {
     --size;
 
     std::optional<Entry> result;
-    auto it_elem = it->second.end();
+    Bucket &bucket = it->second;
 
     switch(tiebreaking_criteria) {
     case TieBreakingCriteria::FIFO:
-        result = it->second.front();
-        it->second.pop_front();
+        result = bucket.front();
+        bucket.pop_front();
         break;
     case TieBreakingCriteria::LIFO:
-        result = it->second.back();
-        it->second.pop_back();
+        result = bucket.back();
+        bucket.pop_back();
         break;
-    case TieBreakingCriteria::RANDOM:
-        srand(time(nullptr));
-        int pos;
-        int i;
-        i = it->second.size();
-        pos = (rand() % i);
-        it_elem = it->second.begin() + pos;
-        result = *it_elem;
-        it->second.erase(it_elem);
+    case TieBreakingCriteria::RANDOM: {
+        /*
+          The order inside a bucket is irrelevant for random tie-breaking,
+          so we move the last entry into the gap instead of erasing from
+          the middle of the bucket.
+        */
+        int pos = rng->random(bucket.size());
+        result = bucket[pos];
+        swap(bucket[pos], bucket.back());
+        bucket.pop_back();
         break;
+    }
     default:
         cout << "Tie-breaking criteria was not found. Using default FIFO." << std::endl;
-        Entry result = it->second.front();
-        it->second.pop_front();
+        result = bucket.front();
+        bucket.pop_front();
     }
 
 
@@ -147,6 +154,13 @@ void CriteriaTieBreakingOpenList<Entry>::get_path_dependent_evaluators(
         evaluator->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void CriteriaTieBreakingOpenList<Entry>::get_evaluators(
+    set<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        evals.insert(evaluator.get());
+}
+
 template<class Entry>
 bool CriteriaTieBreakingOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
@@ -178,23 +192,25 @@ bool CriteriaTieBreakingOpenList<Entry>::is_reliable_dead_end(
 
 CriteriaTieBreakingOpenListFactory::CriteriaTieBreakingOpenListFactory(
     const vector<shared_ptr<Evaluator>> &evals,
-    bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria)
+    bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria,
+    int random_seed)
     : evals(evals),
       unsafe_pruning(unsafe_pruning),
       pref_only(pref_only),
-      tiebreaking_criteria(tiebreaking_criteria) {
+      tiebreaking_criteria(tiebreaking_criteria),
+      random_seed(random_seed) {
 }
 
 unique_ptr<StateOpenList>
 CriteriaTieBreakingOpenListFactory::create_state_open_list() {
     return utils::make_unique_ptr<CriteriaTieBreakingOpenList<StateOpenListEntry>>(
-        evals, unsafe_pruning, pref_only, tiebreaking_criteria);
+        evals, unsafe_pruning, pref_only, tiebreaking_criteria, random_seed);
 }
 
 unique_ptr<EdgeOpenList>
 CriteriaTieBreakingOpenListFactory::create_edge_open_list() {
     return utils::make_unique_ptr<CriteriaTieBreakingOpenList<EdgeOpenListEntry>>(
-        evals, unsafe_pruning, pref_only, tiebreaking_criteria);
+        evals, unsafe_pruning, pref_only, tiebreaking_criteria, random_seed);
 }
 
 class CriteriaTieBreakingOpenListFeature
@@ -213,6 +229,7 @@ public:
             "tiebreaking_criteria",
             "Choose between 'fifo' (First-In-First-Out), 'lifo' (Last-In-First-Out) or at random",
             "fifo");
+        utils::add_rng_options_to_feature(*this);
         add_open_list_options_to_feature(*this);
     }
 
@@ -225,7 +242,8 @@ public:
             opts.get_list<shared_ptr<Evaluator>>("evals"),
             opts.get<bool>("unsafe_pruning"),
             get_open_list_arguments_from_options(opts),
-            opts.get<TieBreakingCriteria>("tiebreaking_criteria")
+            opts.get<TieBreakingCriteria>("tiebreaking_criteria"),
+            utils::get_rng_arguments_from_options(opts)
             );
     }
 };
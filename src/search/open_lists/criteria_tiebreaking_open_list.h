@@ -16,10 +16,12 @@ class CriteriaTieBreakingOpenListFactory : public OpenListFactory {
     bool unsafe_pruning;
     bool pref_only;
     TieBreakingCriteria tiebreaking_criteria;
+    int random_seed;
 public:
     CriteriaTieBreakingOpenListFactory(
         const std::vector<std::shared_ptr<Evaluator>> &evals,
-        bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria);
+        bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria,
+        int random_seed);
 
     virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
     virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
@@ -5,16 +5,18 @@
 #include "selector.h"
 
 #include "../plugins/plugin.h"
+#include "../utils/collections.h"
 #include "../utils/memory.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
 
+#include <algorithm>
 #include <cassert>
 #include <deque>
 #include <map>
 #include <utility>
 #include <vector>
 #include <optional>
-#include <cstdlib>
-#include <ctime>
 #include <iterator>
 
 using namespace std;
@@ -25,11 +27,31 @@ class DivTieBreakingOpenList : public OpenList<Entry> {
     using DepthBucket = deque<Entry>;
     //using Bucket = map<int, DepthBucket>;
 
+    /*
+      Buckets whose keys have at most two components, all in the range
+      [0, max_bucket_key), live in a dense two-level array: the first
+      level is indexed by the first key component (usually f), the
+      second level by the second key component (usually the tie-breaking
+      h). Empty selectors are kept around but reset to their initial
+      state, so they behave like the fresh buckets of the map.
+      All other keys fall back to the ordered map.
+    */
+    struct DenseLayer {
+        vector<Selector<Entry>> selectors;
+        int size = 0;
+        // All selectors with smaller indices are empty.
+        int min_index = 0;
+    };
+
+    vector<DenseLayer> dense_buckets;
+    int dense_size;
+    // All layers with smaller indices are empty.
+    int dense_min_index;
     map<const vector<int>, Selector<Entry>> buckets;
     int size;
-    int max_number_of_entries;
-    int opli_max_depth;
-    int opli_depth_width;
+    PlateauStatistics plateau_statistics;
+    // Reused for computing keys to avoid an allocation per insertion.
+    vector<int> key;
 
     vector<shared_ptr<Evaluator>> evaluators;
     /*
@@ -40,9 +62,18 @@ class DivTieBreakingOpenList : public OpenList<Entry> {
     bool allow_unsafe_pruning;
 
     TieBreakingCriteria tiebreaking_criteria;
+    shared_ptr<utils::RandomNumberGenerator> rng;
+    int max_bucket_key;
+    // Index of the evaluator that computes the f-value.
+    int f_index;
 
     int dimension() const;
 
+    bool is_dense_key(const vector<int> &key) const;
+    Selector<Entry> &get_selector_for_insertion(const vector<int> &key);
+    bool dense_min_precedes_map_min();
+    Entry remove_min_from_dense_buckets();
+
     void div_do_insertion(EvaluationContext &eval_context,
                           const Entry &entry, EvaluationContext &parent_eval_context, int d_val);
 
@@ -53,80 +84,133 @@ protected:
 public:
     DivTieBreakingOpenList(
         const vector<shared_ptr<Evaluator>> &evals,
-        bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria); // TODO: default enum
+        bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria,
+        int max_bucket_key, int random_seed, int f_index); // TODO: default enum
 
     virtual Entry remove_min() override;
     virtual bool empty() const override;
     virtual void clear() override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual void get_evaluators(set<Evaluator *> &evals) override;
     virtual bool is_dead_end(
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
-    vector<int> insert(EvaluationContext &eval_context, const Entry &entry, EvaluationContext &parent_eval_context, int d_val) override;
+    void insert(EvaluationContext &eval_context, const Entry &entry, EvaluationContext &parent_eval_context, int d_val) override;
+    virtual const PlateauStatistics *get_plateau_statistics() const override;
 };
 
 
 template<class Entry>
 DivTieBreakingOpenList<Entry>::DivTieBreakingOpenList( // Constructor when criteria is used
     const vector<shared_ptr<Evaluator>> &evals,
-    bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria)
+    bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria,
+    int max_bucket_key, int random_seed, int f_index)
     : OpenList<Entry>(pref_only),
-      size(0), max_number_of_entries(0), opli_max_depth(0), opli_depth_width(0), evaluators(evals),
+      dense_size(0), dense_min_index(0),
+      size(0), evaluators(evals),
       allow_unsafe_pruning(unsafe_pruning),
-      tiebreaking_criteria(tiebreaking_criteria) {
+      tiebreaking_criteria(tiebreaking_criteria),
+      rng(utils::get_rng(random_seed)),
+      max_bucket_key(max_bucket_key),
+      f_index(f_index) {
+    assert(utils::in_bounds(f_index, evaluators));
+    key.reserve(evaluators.size());
+}
+
+template<class Entry>
+bool DivTieBreakingOpenList<Entry>::is_dense_key(const vector<int> &key) const {
+    if (key.size() > 2)
+        return false;
+    for (int value : key) {
+        if (value < 0 || value >= max_bucket_key)
+            return false;
+    }
+    return true;
+}
+
+template<class Entry>
+Selector<Entry> &DivTieBreakingOpenList<Entry>::get_selector_for_insertion(
+    const vector<int> &key) {
+    if (!is_dense_key(key))
+        return buckets[key];
+
+    int layer_index = key[0];
+    int selector_index = key.size() == 2 ? key[1] : 0;
+    if (layer_index >= static_cast<int>(dense_buckets.size()))
+        dense_buckets.resize(layer_index + 1);
+    DenseLayer &layer = dense_buckets[layer_index];
+    if (selector_index >= static_cast<int>(layer.selectors.size()))
+        layer.selectors.resize(selector_index + 1);
+
+    if (dense_size == 0 || layer_index < dense_min_index)
+        dense_min_index = layer_index;
+    if (layer.size == 0 || selector_index < layer.min_index)
+        layer.min_index = selector_index;
+    ++layer.size;
+    ++dense_size;
+    return layer.selectors[selector_index];
+}
+
+template<class Entry>
+bool DivTieBreakingOpenList<Entry>::dense_min_precedes_map_min() {
+    assert(dense_size > 0);
+    while (dense_buckets[dense_min_index].size == 0)
+        ++dense_min_index;
+    DenseLayer &layer = dense_buckets[dense_min_index];
+    while (layer.selectors[layer.min_index].empty())
+        ++layer.min_index;
+
+    if (buckets.empty())
+        return true;
+    /*
+      Keys in the map always differ from dense keys, so a lexicographic
+      comparison on the (at most two) components suffices.
+    */
+    const vector<int> &map_min_key = buckets.begin()->first;
+    if (dense_min_index != map_min_key[0])
+        return dense_min_index < map_min_key[0];
+    return map_min_key.size() == 2 && layer.min_index < map_min_key[1];
+}
+
+template<class Entry>
+Entry DivTieBreakingOpenList<Entry>::remove_min_from_dense_buckets() {
+    DenseLayer &layer = dense_buckets[dense_min_index];
+    Selector<Entry> &selector = layer.selectors[layer.min_index];
+    Entry result = selector.remove_next(tiebreaking_criteria, *rng);
+    // Behave like the map, which erases empty buckets.
+    if (selector.empty())
+        selector.reset();
+    --layer.size;
+    --dense_size;
+    return result;
 }
 
 template<class Entry>
 void DivTieBreakingOpenList<Entry>::div_do_insertion(
     EvaluationContext &eval_context, const Entry &entry, EvaluationContext &parent_eval_context, int d_val) {
-    vector<int> key;
-    int depth_index = d_val;
-    if (d_val == -1) {
-        key.reserve(evaluators.size());
-        for (const shared_ptr<Evaluator> &evaluator : evaluators)
-            key.push_back(eval_context.get_evaluator_value_or_infinity(evaluator.get()));
-        eval_context.set_d_value(0);
-        depth_index = 0;
-    } else {
-        int f_val = -1;
-        int parent_f_val = -1;
-        key.reserve(evaluators.size());
-        std::string sum_check("sum");
-        for (const shared_ptr<Evaluator> &evaluator : evaluators)
-            if (sum_check.compare(evaluator->get_description()) == 0) { // check if the evaluator is the sum evaluator to get the f-value
-                f_val = eval_context.get_evaluator_value_or_infinity(evaluator.get()); // for A* first takes sum[g + h] = f-value...
-                key.push_back(f_val);
-                parent_f_val = parent_eval_context.get_evaluator_value_or_infinity(evaluator.get());
-            } else {
-                key.push_back(eval_context.get_evaluator_value_or_infinity(evaluator.get())); // ...and then heuristic value h
-            }
-
-        if (f_val < 0 || parent_f_val < 0) {
-            cerr << "The f_value or the parent_f_value could not be calculated in div_do_insertion()." <<endl;
-            exit(-1);
-        }
+    key.clear();
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        key.push_back(eval_context.get_evaluator_value_or_infinity(evaluator.get()));
 
+    int depth_index = 0;
+    if (d_val != -1) {
+        /*
+          The parent's f-value is usually cached in its evaluation
+          context, which the search algorithm keeps for all successors.
+        */
+        int f_val = key[f_index];
+        int parent_f_val = parent_eval_context.get_evaluator_value_or_infinity(
+            evaluators[f_index].get());
         if (eval_context.get_g_value() == parent_eval_context.get_g_value() && f_val == parent_f_val) { // if g and f are the same, then both are in same plateau
-            eval_context.set_d_value(d_val+1); // set the d-val of the child node (or rather eval_context) to d + 1
-            depth_index = d_val + 1;
-        } else {
-            eval_context.set_d_value(0); // else the child is not in the same plateau -> d_val = 0
-            depth_index = 0;
+            depth_index = d_val + 1; // the child is one level deeper in the plateau
         }
     }
+    eval_context.set_d_value(depth_index);
 
-    Selector<Entry> &selector = buckets[key];
-    vector<int> max_selector_values = selector.add(entry, depth_index);
-    if (max_selector_values[0] > max_number_of_entries) {
-        max_number_of_entries = max_selector_values[0];
-    }
-    if (max_selector_values[1] > opli_max_depth) {
-        opli_max_depth = max_selector_values[1];
-    }
-    if (max_selector_values[2] > opli_depth_width) {
-        opli_depth_width = max_selector_values[2];
-    }
+    Selector<Entry> &selector = get_selector_for_insertion(key);
+    selector.add(entry, depth_index);
+    selector.report_statistics(depth_index, plateau_statistics);
     ++size;
 }
 
@@ -134,51 +218,57 @@ template<typename Entry>
 void DivTieBreakingOpenList<Entry>::do_insertion(
         EvaluationContext &eval_context,
         const Entry &entry) {
-    vector<int> key;
-    key.reserve(evaluators.size());
+    key.clear();
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         key.push_back(eval_context.get_evaluator_value_or_infinity(evaluator.get()));
 
-    Selector<Entry> &selector = buckets[key];
+    Selector<Entry> &selector = get_selector_for_insertion(key);
     selector.add(entry, 0);
     ++size;
 }
 
 template<class Entry>
-vector<int> DivTieBreakingOpenList<Entry>::insert( // overrides already implemented method from open_list.h
+void DivTieBreakingOpenList<Entry>::insert( // overrides already implemented method from open_list.h
         EvaluationContext &eval_context, const Entry &entry, EvaluationContext &parent_eval_context, int d_val) {
-    if (false && !eval_context.is_preferred()) // Check for only_preferred is ignored as it is not relevant for the bachelor's thesis
-        return {-1, -1};
+    // Check for only_preferred is ignored as it is not relevant for the bachelor's thesis
     if (!is_dead_end(eval_context))
         div_do_insertion(eval_context, entry, parent_eval_context, d_val);
-    vector<int> max_opli_values = {max_number_of_entries, opli_max_depth, opli_depth_width};
-    return max_opli_values;
+}
+
+template<class Entry>
+const PlateauStatistics *DivTieBreakingOpenList<Entry>::get_plateau_statistics() const {
+    return &plateau_statistics;
 }
 
 template<class Entry>
 Entry DivTieBreakingOpenList<Entry>::remove_min() {
     assert(size > 0);
+    --size;
 
-    auto it = buckets.begin();
-    Selector<Entry> &selector = it->second;
-    assert(!selector.empty());
+    optional<Entry> result;
+    if (dense_size > 0 && dense_min_precedes_map_min()) {
+        result = remove_min_from_dense_buckets();
+    } else {
+        auto it = buckets.begin();
+        Selector<Entry> &selector = it->second;
+        assert(!selector.empty());
 
-    Entry result = it->second.remove_next(tiebreaking_criteria);
-    --size;
+        result = selector.remove_next(tiebreaking_criteria, *rng);
 
-    if (selector.empty()) {
-        buckets.erase(it);
+        if (selector.empty()) {
+            buckets.erase(it);
+        }
     }
 
     if constexpr (std::is_same<Entry, StateID>::value) {
-        if (result == StateID::no_state) {
+        if (*result == StateID::no_state) {
             std::cerr << "ERROR in div_open_list: Selected invalid StateID (no_state)" << std::endl;
             exit(1);
         }
     }
 
 
-    return result;
+    return *result;
 }
 
 template<class Entry>
@@ -188,6 +278,9 @@ bool DivTieBreakingOpenList<Entry>::empty() const {
 
 template<class Entry>
 void DivTieBreakingOpenList<Entry>::clear() {
+    dense_buckets.clear();
+    dense_size = 0;
+    dense_min_index = 0;
     buckets.clear();
     size = 0;
 }
@@ -204,6 +297,13 @@ void DivTieBreakingOpenList<Entry>::get_path_dependent_evaluators(
         evaluator->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void DivTieBreakingOpenList<Entry>::get_evaluators(
+    set<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        evals.insert(evaluator.get());
+}
+
 template<class Entry>
 bool DivTieBreakingOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
@@ -235,23 +335,39 @@ bool DivTieBreakingOpenList<Entry>::is_reliable_dead_end(
 
 DivTieBreakingOpenListFactory::DivTieBreakingOpenListFactory(
     const vector<shared_ptr<Evaluator>> &evals,
-    bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria)
+    bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria,
+    int max_bucket_key, int random_seed, const shared_ptr<Evaluator> &f_eval)
     : evals(evals),
       unsafe_pruning(unsafe_pruning),
       pref_only(pref_only),
-      tiebreaking_criteria(tiebreaking_criteria) {
+      tiebreaking_criteria(tiebreaking_criteria),
+      max_bucket_key(max_bucket_key),
+      random_seed(random_seed),
+      f_index(0) {
+    /*
+      Without an explicit f-evaluator, we use the first sum evaluator
+      (as in sum([g(), h])) or otherwise the first evaluator.
+    */
+    for (size_t i = 0; i < evals.size(); ++i) {
+        if (f_eval ? evals[i] == f_eval : evals[i]->get_description() == "sum") {
+            f_index = i;
+            break;
+        }
+    }
 }
 
 unique_ptr<StateOpenList>
 DivTieBreakingOpenListFactory::create_state_open_list() {
     return utils::make_unique_ptr<DivTieBreakingOpenList<StateOpenListEntry>>(
-        evals, unsafe_pruning, pref_only, tiebreaking_criteria);
+        evals, unsafe_pruning, pref_only, tiebreaking_criteria, max_bucket_key,
+        random_seed, f_index);
 }
 
 unique_ptr<EdgeOpenList>
 DivTieBreakingOpenListFactory::create_edge_open_list() {
     return utils::make_unique_ptr<DivTieBreakingOpenList<EdgeOpenListEntry>>(
-        evals, unsafe_pruning, pref_only, tiebreaking_criteria);
+        evals, unsafe_pruning, pref_only, tiebreaking_criteria, max_bucket_key,
+        random_seed, f_index);
 }
 
 class DivTieBreakingOpenListFeature
@@ -270,6 +386,21 @@ public:
             "tiebreaking_criteria",
             "Choose between 'fifo' (First-In-First-Out), 'lifo' (Last-In-First-Out) or at random",
             "fifo");
+        add_option<int>(
+            "max_bucket_key",
+            "keys with at most two components that all lie in "
+            "[0, max_bucket_key) are stored in a dense bucket array; all "
+            "other keys are stored in an ordered map",
+            "10000",
+            plugins::Bounds("0", "infinity"));
+        add_option<shared_ptr<Evaluator>>(
+            "f_eval",
+            "evaluator among evals that computes the f-value used for "
+            "detecting plateaus in depth-diversified insertion. "
+            "(Optional; by default, the first sum evaluator or, if there "
+            "is none, the first evaluator is used.)",
+            plugins::ArgumentInfo::NO_DEFAULT);
+        utils::add_rng_options_to_feature(*this);
         add_open_list_options_to_feature(*this);
     }
 
@@ -278,11 +409,21 @@ public:
         const utils::Context &context) const override {
         plugins::verify_list_non_empty<shared_ptr<Evaluator>>(
             context, opts, "evals");
+        vector<shared_ptr<Evaluator>> evals =
+            opts.get_list<shared_ptr<Evaluator>>("evals");
+        shared_ptr<Evaluator> f_eval =
+            opts.get<shared_ptr<Evaluator>>("f_eval", nullptr);
+        if (f_eval && find(evals.begin(), evals.end(), f_eval) == evals.end()) {
+            context.error("The f_eval evaluator has to be one of the evals.");
+        }
         return plugins::make_shared_from_arg_tuples<DivTieBreakingOpenListFactory>(
-            opts.get_list<shared_ptr<Evaluator>>("evals"),
+            evals,
             opts.get<bool>("unsafe_pruning"),
             get_open_list_arguments_from_options(opts),
-            opts.get<TieBreakingCriteria>("tiebreaking_criteria")
+            opts.get<TieBreakingCriteria>("tiebreaking_criteria"),
+            opts.get<int>("max_bucket_key"),
+            utils::get_rng_arguments_from_options(opts),
+            f_eval
             );
     }
 };
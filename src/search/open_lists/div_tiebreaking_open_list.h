@@ -16,10 +16,16 @@ class DivTieBreakingOpenListFactory : public OpenListFactory {
     bool unsafe_pruning;
     bool pref_only;
     TieBreakingCriteria tiebreaking_criteria;
+    int max_bucket_key;
+    int random_seed;
+    // Index of the evaluator in evals that computes the f-value.
+    int f_index;
 public:
     DivTieBreakingOpenListFactory(
         const std::vector<std::shared_ptr<Evaluator>> &evals,
-        bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria);
+        bool unsafe_pruning, bool pref_only, const TieBreakingCriteria tiebreaking_criteria,
+        int max_bucket_key, int random_seed,
+        const std::shared_ptr<Evaluator> &f_eval);
 
     virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
     virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
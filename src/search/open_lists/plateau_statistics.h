@@ -0,0 +1,27 @@
+#ifndef OPEN_LISTS_PLATEAU_STATISTICS_H
+#define OPEN_LISTS_PLATEAU_STATISTICS_H
+
+#include <algorithm>
+
+/*
+  Maxima over all plateaus (buckets with equal key) of a
+  depth-diversified open list. The open list updates them in place on
+  every depth-diversified insertion, and the search algorithm reads
+  them once when printing its statistics.
+*/
+struct PlateauStatistics {
+    // Maximal number of entries that a single plateau held at once.
+    int max_entries = 0;
+    // Maximal depth level reached inside a plateau.
+    int max_depth = 0;
+    // Maximal number of entries that a single depth level held at once.
+    int max_depth_width = 0;
+
+    void update(int entries, int depth, int depth_width) {
+        max_entries = std::max(max_entries, entries);
+        max_depth = std::max(max_depth, depth);
+        max_depth_width = std::max(max_depth_width, depth_width);
+    }
+};
+
+#endif
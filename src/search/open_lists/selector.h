@@ -3,6 +3,11 @@
 
 #include <deque>
 #include "./div_tiebreaking_open_list.h" // for the enums
+#include "./plateau_statistics.h"
+#include "../utils/rng.h"
+#include <bit>
+#include <cassert>
+#include <cstdint>
 #include <optional>
 #include <vector>
 using std::deque;
@@ -12,18 +17,60 @@ class Selector {
 
     int counter;
     int number_of_entries;
-    int max_depth;
-    int depth_width;
 
     using DepthBucket = deque<Entry>;
-    deque<DepthBucket> depth_bucket_list;
+    /*
+      We use a vector rather than a deque for the depth levels because a
+      default-constructed deque already allocates memory, and the dense
+      bucket array of DivTieBreakingOpenList keeps many empty selectors.
+    */
+    std::vector<DepthBucket> depth_bucket_list;
+    /*
+      Bitmap of the non-empty depth levels (bit d of word d / 64 is set
+      iff depth_bucket_list[d] is non-empty). Together with
+      number_of_entries, this avoids scanning all depth levels when
+      checking for emptiness or moving the counter.
+    */
+    std::vector<uint64_t> non_empty_levels;
+
+    static const int BITS_PER_WORD = 64;
+
+    void mark_non_empty(int depth) {
+        non_empty_levels[depth / BITS_PER_WORD] |=
+            uint64_t(1) << (depth % BITS_PER_WORD);
+    }
+
+    void mark_empty(int depth) {
+        non_empty_levels[depth / BITS_PER_WORD] &=
+            ~(uint64_t(1) << (depth % BITS_PER_WORD));
+    }
+
+    // Return the deepest non-empty depth level below the given one, or -1.
+    int find_non_empty_level_below(int depth) const {
+        if (depth <= 0)
+            return -1;
+        int pos = depth - 1;
+        int word_index = pos / BITS_PER_WORD;
+        int bit = pos % BITS_PER_WORD;
+        uint64_t word = non_empty_levels[word_index];
+        if (bit != BITS_PER_WORD - 1)
+            word &= (uint64_t(1) << (bit + 1)) - 1;
+        while (true) {
+            if (word)
+                return word_index * BITS_PER_WORD + std::bit_width(word) - 1;
+            if (word_index == 0)
+                return -1;
+            word = non_empty_levels[--word_index];
+        }
+    }
 
 public:
     Selector()
-        : counter(-1), number_of_entries(0), max_depth(0), depth_width(0) {
+        : counter(-1), number_of_entries(0) {
     }
 
-    Entry remove_next(div_tiebreaking_open_list::TieBreakingCriteria tiebreaking_criteria) {
+    Entry remove_next(div_tiebreaking_open_list::TieBreakingCriteria tiebreaking_criteria,
+                      utils::RandomNumberGenerator &rng) {
         if (empty()) {
             std::cerr << "Selector::remove_next() called on empty Selector" << std::endl;
             exit(1);
@@ -63,16 +110,16 @@ public:
                 break;
             }
             case div_tiebreaking_open_list::TieBreakingCriteria::RANDOM: {
-                srand(time(nullptr));
-                int pos;
-                int i;
-                i = depth_bucket_list[counter].size();
-                pos = (rand() % i);
-
-                auto it = depth_bucket_list[counter].begin();
-                std::advance(it, pos);
-                result = *it;
-                depth_bucket_list[counter].erase(it);
+                /*
+                  The order inside a DepthBucket is irrelevant for random
+                  tie-breaking, so we move the last entry into the gap
+                  instead of erasing from the middle of the bucket.
+                */
+                DepthBucket &bucket = depth_bucket_list[counter];
+                int pos = rng.random(bucket.size());
+                result = bucket[pos];
+                std::swap(bucket[pos], bucket.back());
+                bucket.pop_back();
                 break;
             }
             default: {
@@ -82,6 +129,8 @@ public:
             }
         }
         --number_of_entries;
+        if (depth_bucket_list[counter].empty())
+            mark_empty(counter);
         //std::cout << "remove_next() in selector: " << this  << ", Number of entries after :" << number_of_entries << std::endl;
 
 
@@ -100,64 +149,61 @@ public:
         return *result;
     }
 
-    std::vector<int> add(Entry entry, int d_value) {
-        if (depth_bucket_list.size() <= d_value) {
+    void add(Entry entry, int d_value) {
+        if (static_cast<int>(depth_bucket_list.size()) <= d_value) {
             depth_bucket_list.resize(d_value + 1);
+            non_empty_levels.resize(d_value / BITS_PER_WORD + 1, 0);
         }
+        if (depth_bucket_list[d_value].empty())
+            mark_non_empty(d_value);
         depth_bucket_list[d_value].push_back(entry);
 
-        if ((depth_bucket_list.size() - 1) > max_depth) { // updates maximal depth that has been reached until this point
-            max_depth = (depth_bucket_list.size() - 1);
-        }
-
-        if (depth_bucket_list[d_value].size() > depth_width) { // updates the size of the depthbuckets aka. the width of a depth level
-            depth_width = depth_bucket_list[d_value].size();
-        }
-
         ++number_of_entries;
         //std::cout << "add() in selector: " << this  << ", Number of entries after :" << number_of_entries << std::endl;
-        std::vector<int> max_values = {number_of_entries, max_depth, depth_width};
-        return max_values;
     }
 
-    bool empty() {
-        for (const auto &bucket : depth_bucket_list) {
-            if (!bucket.empty())
-                return false;
-        }
-        return true;
+    /*
+      Report the current number of entries, the maximal depth reached
+      so far and the width of the given depth level.
+    */
+    void report_statistics(int d_value, PlateauStatistics &statistics) const {
+        statistics.update(number_of_entries,
+                          depth_bucket_list.size() - 1,
+                          depth_bucket_list[d_value].size());
+    }
+
+    bool empty() const {
+        return number_of_entries == 0;
+    }
+
+    /*
+      Return an empty selector to the state of a newly constructed one,
+      so that reusing it behaves like using a fresh selector.
+    */
+    void reset() {
+        assert(empty());
+        counter = -1;
+        depth_bucket_list.clear();
+        non_empty_levels.clear();
     }
 
 protected:
     void decrease_counter() {
-        --counter;
+        counter = find_non_empty_level_below(counter);
         //std::cout << "decrease() in selector: " << this << ", counter decreased to: " << counter << std::endl;
 
-        while (counter >= 0 && depth_bucket_list[counter].empty()) {
-            //std::cout << "Bucket at counter " << counter << " is empty. Decreasing further." << std::endl;
-            --counter;
-        }
-
         if (counter < 0) {
             rewind_counter();
         }
     }
 
     void rewind_counter() {
-        if (depth_bucket_list.empty()) {
+        // finds deepest non-empty DepthBucket
+        counter = find_non_empty_level_below(depth_bucket_list.size());
+        if (counter < 0) {
             counter = 0;
-            return;
-        } else {
-            for (int i = depth_bucket_list.size() - 1; i >= 0; i--) { // goes over all DepthBuckets and finds deepest non-empty one
-                if (!depth_bucket_list[i].empty()) {
-                    counter = i;
-                    //std::cout << "rewind() in selector: " << this  << ", counter rewinded to:" << counter << std::endl;
-                    return;
-                }
-            }
         }
-        counter = 0;
-        //std::cout << "end rewind() in selector: " << this  << ", counter set to:" << counter << std::endl;
+        //std::cout << "rewind() in selector: " << this  << ", counter rewinded to:" << counter << std::endl;
     }
 };
 
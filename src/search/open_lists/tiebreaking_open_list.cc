@@ -45,6 +45,7 @@ namespace tiebreaking_open_list {
         virtual bool empty() const override;
         virtual void clear() override;
         virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+        virtual void get_evaluators(set<Evaluator *> &evals) override;
         virtual bool is_dead_end(
                 EvaluationContext &eval_context) const override;
         virtual bool is_reliable_dead_end(
@@ -111,6 +112,13 @@ namespace tiebreaking_open_list {
             evaluator->get_path_dependent_evaluators(evals);
     }
 
+    template<class Entry>
+    void TieBreakingOpenList<Entry>::get_evaluators(
+            set<Evaluator *> &evals) {
+        for (const shared_ptr<Evaluator> &evaluator : evaluators)
+            evals.insert(evaluator.get());
+    }
+
     template<class Entry>
     bool TieBreakingOpenList<Entry>::is_dead_end(
             EvaluationContext &eval_context) const {
@@ -4,7 +4,6 @@
 
 #include <algorithm>
 #include <cassert>
-#include <iostream>
 #include <limits>
 
 using namespace std;
@@ -13,29 +12,36 @@ namespace pdbs {
 CanonicalPDBs::CanonicalPDBs(
     const shared_ptr<PDBCollection> &pdbs,
     const shared_ptr<vector<PatternClique>> &pattern_cliques)
-    : pdbs(pdbs), pattern_cliques(pattern_cliques) {
+    : pdbs(pdbs), pattern_cliques(pattern_cliques), lookup(*pdbs) {
     assert(pdbs);
     assert(pattern_cliques);
+    first_member.reserve(pattern_cliques->size() + 1);
+    first_member.push_back(0);
+    for (const PatternClique &clique : *pattern_cliques) {
+        clique_members.insert(
+            clique_members.end(), clique.begin(), clique.end());
+        first_member.push_back(clique_members.size());
+    }
 }
 
 int CanonicalPDBs::get_value(const State &state) const {
+    return get_value(state, h_values);
+}
+
+int CanonicalPDBs::get_value(
+    const State &state, vector<int> &pdb_values) const {
     // If we have an empty collection, then pattern_cliques = { \emptyset }.
     assert(!pattern_cliques->empty());
-    int max_h = 0;
-    vector<int> h_values;
-    h_values.reserve(pdbs->size());
     state.unpack();
-    for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
-        int h = pdb->get_value(state.get_unpacked_values());
-        if (h == numeric_limits<int>::max()) {
-            return numeric_limits<int>::max();
-        }
-        h_values.push_back(h);
+    if (!lookup.compute_values(state.get_unpacked_values(), pdb_values)) {
+        return numeric_limits<int>::max();
     }
-    for (const PatternClique &clique : *pattern_cliques) {
+    int max_h = 0;
+    int num_cliques = first_member.size() - 1;
+    for (int i = 0; i < num_cliques; ++i) {
         int clique_h = 0;
-        for (PatternID pdb_index : clique) {
-            clique_h += h_values[pdb_index];
+        for (int j = first_member[i]; j < first_member[i + 1]; ++j) {
+            clique_h += pdb_values[clique_members[j]];
         }
         max_h = max(max_h, clique_h);
     }
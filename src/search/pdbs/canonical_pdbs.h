@@ -1,6 +1,7 @@
 #ifndef PDBS_CANONICAL_PDBS_H
 #define PDBS_CANONICAL_PDBS_H
 
+#include "pdb_lookup.h"
 #include "types.h"
 
 #include <memory>
@@ -12,6 +13,13 @@ class CanonicalPDBs {
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
 
+    PDBLookup lookup;
+    // Members of clique i: clique_members[first_member[i] ... first_member[i + 1]).
+    std::vector<int> first_member;
+    std::vector<int> clique_members;
+    // Buffer for the PDB values of the evaluated state.
+    mutable std::vector<int> h_values;
+
 public:
     CanonicalPDBs(
         const std::shared_ptr<PDBCollection> &pdbs,
@@ -19,6 +27,12 @@ public:
     ~CanonicalPDBs() = default;
 
     int get_value(const State &state) const;
+
+    /*
+      Like get_value, but also store the value of each PDB in pdb_values.
+      If a PDB detects a dead end, pdb_values is incomplete.
+    */
+    int get_value(const State &state, std::vector<int> &pdb_values) const;
 };
 }
 
@@ -0,0 +1,76 @@
+#include "distance_table.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace pdbs {
+DistanceTable::DistanceTable(const vector<int> &distances)
+    : num_ranks(distances.size()),
+      num_entries(distances.size()),
+      compression_shift(0) {
+    pack(distances);
+}
+
+void DistanceTable::pack(const vector<int> &entries) {
+    assert(static_cast<int>(entries.size()) == num_entries);
+    int max_finite_value = 0;
+    for (int value : entries) {
+        assert(value >= 0);
+        if (value != numeric_limits<int>::max())
+            max_finite_value = max(max_finite_value, value);
+    }
+
+    // The largest code of each width is reserved for infinity.
+    entry_bits_shift = 2;
+    while (entry_bits_shift < 5 &&
+           static_cast<uint64_t>(max_finite_value) >=
+           (uint64_t(1) << (1 << entry_bits_shift)) - 1) {
+        ++entry_bits_shift;
+    }
+    int bits_per_entry = 1 << entry_bits_shift;
+    entries_per_word_shift = 5 - entry_bits_shift;
+    entry_mask = static_cast<uint32_t>((uint64_t(1) << bits_per_entry) - 1);
+
+    int entries_per_word = 1 << entries_per_word_shift;
+    words.assign((num_entries + entries_per_word - 1) / entries_per_word, 0);
+    words.shrink_to_fit();
+    for (int index = 0; index < num_entries; ++index) {
+        int value = entries[index];
+        uint32_t code = (value == numeric_limits<int>::max())
+            ? entry_mask : static_cast<uint32_t>(value);
+        int shift = (index & (entries_per_word - 1)) << entry_bits_shift;
+        words[index >> entries_per_word_shift] |= code << shift;
+    }
+}
+
+vector<int> DistanceTable::unpack() const {
+    vector<int> entries;
+    entries.reserve(num_entries);
+    for (int index = 0; index < num_entries; ++index)
+        entries.push_back(get(index << compression_shift));
+    return entries;
+}
+
+void DistanceTable::compress(size_t max_bytes) {
+    if (get_memory_usage() <= max_bytes || num_entries <= 1)
+        return;
+    vector<int> entries = unpack();
+    while (num_entries > 1) {
+        int num_merged_entries = (num_entries + 1) / 2;
+        for (int index = 0; index < num_merged_entries; ++index) {
+            int value = entries[2 * index];
+            if (2 * index + 1 < num_entries)
+                value = min(value, entries[2 * index + 1]);
+            entries[index] = value;
+        }
+        entries.resize(num_merged_entries);
+        num_entries = num_merged_entries;
+        ++compression_shift;
+        pack(entries);
+        if (get_memory_usage() <= max_bytes)
+            break;
+    }
+}
+}
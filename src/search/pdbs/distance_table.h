@@ -0,0 +1,72 @@
+#ifndef PDBS_DISTANCE_TABLE_H
+#define PDBS_DISTANCE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pdbs {
+/*
+  Goal distances of the abstract states of a projection, indexed by
+  rank. Entries are packed into 4, 8, 16 or 32 bits, the smallest
+  width that can hold the largest finite distance. The largest value
+  of each width encodes infinity (dead ends).
+
+  With min-compression, 2^k adjacent ranks share one entry that holds
+  the minimum of their distances. This loses information but keeps the
+  distances admissible.
+*/
+class DistanceTable {
+    std::vector<std::uint32_t> words;
+    // Number of ranks, independent of the compression.
+    int num_ranks;
+    // Number of entries after compression.
+    int num_entries;
+    int compression_shift;
+    // log2 of the number of bits per entry and of the entries per word.
+    int entry_bits_shift;
+    int entries_per_word_shift;
+    std::uint32_t entry_mask;
+
+    void pack(const std::vector<int> &entries);
+    std::vector<int> unpack() const;
+public:
+    explicit DistanceTable(const std::vector<int> &distances);
+
+    int get(int rank) const {
+        int index = rank >> compression_shift;
+        std::uint32_t word = words[index >> entries_per_word_shift];
+        int entries_per_word = 1 << entries_per_word_shift;
+        int shift = (index & (entries_per_word - 1)) << entry_bits_shift;
+        std::uint32_t code = (word >> shift) & entry_mask;
+        return code == entry_mask
+               ? std::numeric_limits<int>::max() : static_cast<int>(code);
+    }
+
+    int size() const {
+        return num_ranks;
+    }
+
+    int get_bits_per_entry() const {
+        return 1 << entry_bits_shift;
+    }
+
+    // Number of adjacent ranks that share one entry.
+    int get_compression_factor() const {
+        return 1 << compression_shift;
+    }
+
+    std::size_t get_memory_usage() const {
+        return words.size() * sizeof(std::uint32_t);
+    }
+
+    /*
+      Merge adjacent ranks (min-compression) until the table needs at most
+      max_bytes, or until a single entry is left.
+    */
+    void compress(std::size_t max_bytes);
+};
+}
+
+#endif
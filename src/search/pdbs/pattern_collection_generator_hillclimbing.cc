@@ -17,11 +17,13 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -197,6 +199,7 @@ void PatternCollectionGeneratorHillclimbing::sample_states(
 pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     const vector<State> &samples,
     const vector<int> &samples_h_values,
+    const vector<vector<int>> &samples_pdb_values,
     PDBCollection &candidate_pdbs) {
     /*
       TODO: The original implementation by Haslum et al. uses A* to compute
@@ -205,53 +208,66 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
       We require that a pattern must have an improvement of at least one in
       order to be taken into account.
     */
-    int improvement = 0;
-    int best_pdb_index = -1;
-
-    // Iterate over all candidates and search for the best improving pattern/pdb
-    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
+    int num_candidates = candidate_pdbs.size();
+    for (int i = 0; i < num_candidates; ++i) {
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
-        if (!pdb) {
-            /* candidate pattern is too large or has already been added to
-               the canonical heuristic. */
-            continue;
-        }
         /*
           If a candidate's size added to the current collection's size exceeds
           the maximum collection size, then forget the pdb.
         */
-        int combined_size = current_pdbs->get_size() + pdb->get_size();
-        if (combined_size > collection_max_size) {
+        if (pdb && current_pdbs->get_size() + pdb->get_size() >
+            collection_max_size) {
             candidate_pdbs[i] = nullptr;
-            continue;
         }
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        vector<PatternClique> pattern_cliques =
-            current_pdbs->get_pattern_cliques(pdb->get_pattern());
-        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
-            const State &sample = samples[sample_id];
-            assert(utils::in_bounds(sample_id, samples_h_values));
-            int h_collection = samples_h_values[sample_id];
-            if (is_heuristic_improved(
-                    *pdb, sample, h_collection,
-                    *current_pdbs->get_pattern_databases(), pattern_cliques)) {
-                ++count;
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
+      The jobs only read shared data and write their own count.
+    */
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    vector<int> counts(num_candidates, 0);
+    atomic<bool> timeout(false);
+    utils::run_preprocessing_jobs(
+        num_candidates,
+        [&](int i) {
+            const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
+            if (!pdb) {
+                /* candidate pattern is too large or has already been added to
+                   the canonical heuristic. */
+                return;
             }
-        }
+            if (timeout || hill_climbing_timer->is_expired()) {
+                timeout = true;
+                return;
+            }
+            vector<PatternClique> pattern_cliques =
+                current_pdbs->get_pattern_cliques(pdb->get_pattern());
+            for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+                assert(utils::in_bounds(sample_id, samples_h_values));
+                if (is_heuristic_improved(
+                        *pdb, samples[sample_id], samples_h_values[sample_id],
+                        samples_pdb_values[sample_id], pattern_cliques)) {
+                    ++counts[i];
+                }
+            }
+        },
+        [](int) {
+            return 0;
+        });
+    if (timeout)
+        throw HillClimbingTimeout();
+
+    int improvement = 0;
+    int best_pdb_index = -1;
+    for (int i = 0; i < num_candidates; ++i) {
+        int count = counts[i];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -267,7 +283,8 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
 
 bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
     const PatternDatabase &pdb, const State &sample, int h_collection,
-    const PDBCollection &pdbs, const vector<PatternClique> &pattern_cliques) {
+    const vector<int> &pdb_values,
+    const vector<PatternClique> &pattern_cliques) const {
     const vector<int> &sample_data = sample.get_unpacked_values();
     // h_pattern: h-value of the new pattern
     int h_pattern = pdb.get_value(sample_data);
@@ -280,18 +297,17 @@ bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
     if (h_collection == numeric_limits<int>::max())
         return false;
 
-    vector<int> h_values;
-    h_values.reserve(pdbs.size());
-    for (const shared_ptr<PatternDatabase> &p : pdbs) {
-        int h = p->get_value(sample_data);
-        if (h == numeric_limits<int>::max())
-            return false;
-        h_values.push_back(h);
-    }
+    /*
+      Every clique additive with the new pattern is a subset of a clique
+      of the current collection, so its h-value is at most h_collection.
+    */
+    if (h_pattern == 0)
+        return false;
+
     for (const PatternClique &clilque : pattern_cliques) {
         int h_clique = 0;
         for (PatternID pattern_id : clilque) {
-            h_clique += h_values[pattern_id];
+            h_clique += pdb_values[pattern_id];
         }
         if (h_pattern + h_clique > h_collection) {
             /*
@@ -306,7 +322,12 @@ bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
 
 void PatternCollectionGeneratorHillclimbing::hill_climbing(
     const TaskProxy &task_proxy) {
-    hill_climbing_timer = new utils::CountdownTimer(max_time);
+    /*
+      With several preprocessing threads, CPU time grows faster than
+      wall-clock time, so we measure the limit in wall-clock time.
+    */
+    hill_climbing_timer = new utils::CountdownTimer(
+        max_time, utils::get_preprocessing_threads() > 1);
 
     if (log.is_at_least_normal()) {
         log << "Average operator cost: "
@@ -345,6 +366,7 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     sampling::RandomWalkSampler sampler(task_proxy, *rng);
     vector<State> samples;
     vector<int> samples_h_values;
+    vector<vector<int>> samples_pdb_values;
 
     try {
         while (true) {
@@ -368,12 +390,20 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
             samples.clear();
             samples_h_values.clear();
             sample_states(sampler, init_h, samples);
-            for (const State &sample : samples) {
-                samples_h_values.push_back(current_pdbs->get_value(sample));
+            /*
+              This also unpacks the samples, so that the candidates can be
+              evaluated on them concurrently.
+            */
+            samples_pdb_values.resize(samples.size());
+            for (size_t i = 0; i < samples.size(); ++i) {
+                samples_h_values.push_back(
+                    current_pdbs->get_value(samples[i], samples_pdb_values[i]));
             }
 
             pair<int, int> improvement_and_index =
-                find_best_improving_pdb(samples, samples_h_values, candidate_pdbs);
+                find_best_improving_pdb(
+                    samples, samples_h_values, samples_pdb_values,
+                    candidate_pdbs);
             int improvement = improvement_and_index.first;
             int best_pdb_index = improvement_and_index.second;
 
@@ -551,7 +581,9 @@ void add_hillclimbing_options_to_feature(plugins::Feature &feature) {
         "collection via hill climbing. If set to 0, no hill climbing "
         "is performed at all. Note that this limit only affects hill "
         "climbing. Use max_time_dominance_pruning to limit the time "
-        "spent for pruning dominated patterns.",
+        "spent for pruning dominated patterns. With more than one "
+        "preprocessing thread (--preprocessing-threads), the limit is "
+        "measured in wall-clock time instead of CPU time.",
         "infinity",
         plugins::Bounds("0.0", "infinity"));
     utils::add_rng_options_to_feature(feature);
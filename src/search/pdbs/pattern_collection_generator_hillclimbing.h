@@ -78,24 +78,31 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
       the index of the best pdb in candidate_pdbs.
+
+      samples_h_values and samples_pdb_values hold the h-value of the current
+      collection and the values of its PDBs for each sample. They are computed
+      once for all candidates. The candidates are scored in parallel with the
+      preprocessing threads (see utils/parallel.h).
     */
     std::pair<int, int> find_best_improving_pdb(
         const std::vector<State> &samples,
         const std::vector<int> &samples_h_values,
+        const std::vector<std::vector<int>> &samples_pdb_values,
         PDBCollection &candidate_pdbs);
 
     /*
       Returns true iff the h-value of the new pattern (from pdb) plus the
       h-value of all pattern cliques from the current pattern
       collection heuristic if the new pattern was added to it is greater than
-      the h-value of the current pattern collection.
+      the h-value of the current pattern collection. pdb_values holds the
+      values of the PDBs of the current collection for the sample.
     */
     bool is_heuristic_improved(
         const PatternDatabase &pdb,
         const State &sample,
         int h_collection,
-        const PDBCollection &pdbs,
-        const std::vector<PatternClique> &pattern_cliques);
+        const std::vector<int> &pdb_values,
+        const std::vector<PatternClique> &pattern_cliques) const;
 
     /*
       This is the core algorithm of this class. The initial PDB collection
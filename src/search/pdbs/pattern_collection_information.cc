@@ -63,12 +63,7 @@ void PatternCollectionInformation::create_pdbs_if_missing() {
         if (log.is_at_least_normal()) {
             log << "Computing PDBs for pattern collection..." << endl;
         }
-        pdbs = make_shared<PDBCollection>();
-        for (const Pattern &pattern : *patterns) {
-            shared_ptr<PatternDatabase> pdb =
-                compute_pdb(task_proxy, pattern);
-            pdbs->push_back(pdb);
-        }
+        pdbs = compute_pdbs(task_proxy, *patterns);
         if (log.is_at_least_normal()) {
             log << "Done computing PDBs for pattern collection: "
                 << timer << endl;
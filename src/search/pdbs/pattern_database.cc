@@ -2,6 +2,7 @@
 
 #include "../task_utils/task_properties.h"
 
+#include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
 
@@ -58,19 +59,25 @@ PatternDatabase::PatternDatabase(
     Projection &&projection,
     vector<int> &&distances)
     : projection(move(projection)),
-      distances(move(distances)) {
+      distances(distances) {
+    utils::release_vector_memory(distances);
 }
 
 int PatternDatabase::get_value(const vector<int> &state) const {
-    return distances[projection.rank(state)];
+    return distances.get(projection.rank(state));
+}
+
+void PatternDatabase::compress(size_t max_bytes) {
+    distances.compress(max_bytes);
 }
 
 double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
-    for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+    for (int i = 0; i < distances.size(); ++i) {
+        int distance = distances.get(i);
+        if (distance != numeric_limits<int>::max()) {
+            sum += distance;
             ++size;
         }
     }
@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_DATABASE_H
 #define PDBS_PATTERN_DATABASE_H
 
+#include "distance_table.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -45,7 +46,7 @@ class PatternDatabase {
       final h-values for abstract-states.
       dead-ends are represented by numeric_limits<int>::max()
     */
-    std::vector<int> distances;
+    DistanceTable distances;
 public:
     PatternDatabase(
         Projection &&projection,
@@ -56,11 +57,31 @@ public:
         return projection.get_pattern();
     }
 
+    const Projection &get_projection() const {
+        return projection;
+    }
+
+    const DistanceTable &get_distance_table() const {
+        return distances;
+    }
+
     // The size of the PDB is the number of abstract states.
     int get_size() const {
         return projection.get_num_abstract_states();
     }
 
+    // Bytes used by the distance table.
+    std::size_t get_memory_usage() const {
+        return distances.get_memory_usage();
+    }
+
+    /*
+      Shrink the distance table to at most max_bytes (if possible) by
+      merging adjacent abstract states into their minimum distance. The
+      PDB stays admissible but may no longer be consistent.
+    */
+    void compress(std::size_t max_bytes);
+
     /*
       Return the average h-value over all states, where dead-ends are
       ignored (they neither increase the sum of all h-values nor the
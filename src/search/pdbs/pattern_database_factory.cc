@@ -6,11 +6,15 @@
 
 #include "../algorithms/priority_queues.h"
 #include "../task_utils/task_properties.h"
+#include "../utils/hash.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
+#include "../utils/persistent_cache.h"
 #include "../utils/rng.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <limits>
 #include <vector>
 
@@ -91,8 +95,27 @@ class PatternDatabaseFactory {
     */
     bool is_goal_state(int state_index) const;
 
+    /*
+      Enumerate the abstract goal states by ranking all assignments to
+      the pattern variables that do not occur in the goal.
+    */
+    vector<int> compute_goal_states() const;
+
     void compute_distances(const MatchTree &match_tree, bool compute_plan);
 
+    /*
+      Regression with breadth-first search when all abstract operators
+      have cost 1, and with Dijkstra's algorithm otherwise. The
+      AdaptiveQueue used for Dijkstra is a bucket queue as long as the
+      costs are small integers.
+    */
+    void compute_distances_unit_cost(
+        const MatchTree &match_tree, const vector<int> &goal_states,
+        bool compute_plan);
+    void compute_distances_dijkstra(
+        const MatchTree &match_tree, const vector<int> &goal_states,
+        bool compute_plan);
+
     void compute_plan(
         const MatchTree &match_tree,
         const shared_ptr<utils::RandomNumberGenerator> &rng,
@@ -113,6 +136,10 @@ public:
             move(distances));
     }
 
+    const vector<int> &get_distances() const {
+        return distances;
+    }
+
     vector<vector<OperatorID>> &&extract_wildcard_plan() {
         return move(wildcard_plan);
     }
@@ -292,20 +319,52 @@ bool PatternDatabaseFactory::is_goal_state(int state_index) const {
     return true;
 }
 
-void PatternDatabaseFactory::compute_distances(
-    const MatchTree &match_tree, bool compute_plan) {
-    distances.reserve(projection.get_num_abstract_states());
-    // first implicit entry: priority, second entry: index for an abstract state
-    priority_queues::AdaptiveQueue<int> pq;
+vector<int> PatternDatabaseFactory::compute_goal_states() const {
+    const Pattern &pattern = projection.get_pattern();
+    vector<bool> is_goal_var(pattern.size(), false);
+    int base_index = 0;
+    for (const FactPair &abstract_goal : abstract_goals) {
+        is_goal_var[abstract_goal.var] = true;
+        base_index += abstract_goal.value *
+            projection.get_multiplier(abstract_goal.var);
+    }
+    vector<int> free_vars;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        if (!is_goal_var[i])
+            free_vars.push_back(i);
+    }
 
-    // initialize queue
-    for (int state_index = 0; state_index < projection.get_num_abstract_states(); ++state_index) {
-        if (is_goal_state(state_index)) {
-            pq.push(0, state_index);
-            distances.push_back(0);
-        } else {
-            distances.push_back(numeric_limits<int>::max());
+    // Count through the assignments to free_vars like an odometer.
+    vector<int> goal_states;
+    vector<int> values(free_vars.size(), 0);
+    int state_index = base_index;
+    while (true) {
+        goal_states.push_back(state_index);
+        size_t pos = 0;
+        for (; pos < free_vars.size(); ++pos) {
+            int var = free_vars[pos];
+            int multiplier = projection.get_multiplier(var);
+            if (++values[pos] < variables[pattern[var]].get_domain_size()) {
+                state_index += multiplier;
+                break;
+            }
+            state_index -= (values[pos] - 1) * multiplier;
+            values[pos] = 0;
         }
+        if (pos == free_vars.size())
+            break;
+    }
+    return goal_states;
+}
+
+void PatternDatabaseFactory::compute_distances(
+    const MatchTree &match_tree, bool compute_plan) {
+    distances.assign(
+        projection.get_num_abstract_states(), numeric_limits<int>::max());
+    vector<int> goal_states = compute_goal_states();
+    for (int state_index : goal_states) {
+        assert(is_goal_state(state_index));
+        distances[state_index] = 0;
     }
 
     if (compute_plan) {
@@ -322,7 +381,57 @@ void PatternDatabaseFactory::compute_distances(
         generating_op_ids.resize(projection.get_num_abstract_states());
     }
 
+    bool unit_cost = all_of(
+        abstract_ops.begin(), abstract_ops.end(),
+        [](const AbstractOperator &op) {return op.get_cost() == 1;});
+    if (unit_cost) {
+        compute_distances_unit_cost(match_tree, goal_states, compute_plan);
+    } else {
+        compute_distances_dijkstra(match_tree, goal_states, compute_plan);
+    }
+}
+
+void PatternDatabaseFactory::compute_distances_unit_cost(
+    const MatchTree &match_tree, const vector<int> &goal_states,
+    bool compute_plan) {
+    /*
+      With unit costs, the first time a state is reached is along a
+      shortest path, so every state is queued and expanded at most once.
+    */
+    vector<int> queue(goal_states);
+    queue.reserve(projection.get_num_abstract_states());
+    vector<int> applicable_operator_ids;
+    for (size_t next = 0; next < queue.size(); ++next) {
+        int state_index = queue[next];
+        int successor_distance = distances[state_index] + 1;
+
+        // regress abstract_state
+        applicable_operator_ids.clear();
+        match_tree.get_applicable_operator_ids(state_index, applicable_operator_ids);
+        for (int op_id : applicable_operator_ids) {
+            const AbstractOperator &op = abstract_ops[op_id];
+            int predecessor = state_index + op.get_hash_effect();
+            if (distances[predecessor] == numeric_limits<int>::max()) {
+                distances[predecessor] = successor_distance;
+                queue.push_back(predecessor);
+                if (compute_plan) {
+                    generating_op_ids[predecessor] = op_id;
+                }
+            }
+        }
+    }
+}
+
+void PatternDatabaseFactory::compute_distances_dijkstra(
+    const MatchTree &match_tree, const vector<int> &goal_states,
+    bool compute_plan) {
+    // first implicit entry: priority, second entry: index for an abstract state
+    priority_queues::AdaptiveQueue<int> pq;
+    for (int state_index : goal_states)
+        pq.push(0, state_index);
+
     // Dijkstra loop
+    vector<int> applicable_operator_ids;
     while (!pq.empty()) {
         pair<int, int> node = pq.pop();
         int distance = node.first;
@@ -332,7 +441,7 @@ void PatternDatabaseFactory::compute_distances(
         }
 
         // regress abstract_state
-        vector<int> applicable_operator_ids;
+        applicable_operator_ids.clear();
         match_tree.get_applicable_operator_ids(state_index, applicable_operator_ids);
         for (int op_id : applicable_operator_ids) {
             const AbstractOperator &op = abstract_ops[op_id];
@@ -430,6 +539,17 @@ PatternDatabaseFactory::PatternDatabaseFactory(
     }
 }
 
+static uint64_t get_pdb_cache_key(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    utils::HashState hash_state;
+    utils::feed(hash_state, task_properties::get_task_fingerprint(task_proxy));
+    utils::feed(hash_state, pattern);
+    utils::feed(hash_state, operator_costs);
+    return hash_state.get_hash64();
+}
+
 shared_ptr<PatternDatabase> compute_pdb(
     const TaskProxy &task_proxy,
     const Pattern &pattern,
@@ -439,6 +559,56 @@ shared_ptr<PatternDatabase> compute_pdb(
     return pdb_factory.extract_pdb();
 }
 
+shared_ptr<PatternDatabase> compute_cached_pdb(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    if (!utils::is_persistent_cache_enabled()) {
+        return compute_pdb(task_proxy, pattern, operator_costs);
+    }
+
+    uint64_t cache_key = get_pdb_cache_key(task_proxy, pattern, operator_costs);
+    vector<int> distances;
+    if (utils::load_from_persistent_cache("pdb", cache_key, distances)) {
+        Projection projection(task_proxy, pattern);
+        if (static_cast<int>(distances.size()) ==
+            projection.get_num_abstract_states()) {
+            return make_shared<PatternDatabase>(
+                move(projection), move(distances));
+        }
+    }
+    PatternDatabaseFactory pdb_factory(task_proxy, pattern, operator_costs);
+    utils::store_in_persistent_cache(
+        "pdb", cache_key, pdb_factory.get_distances());
+    return pdb_factory.extract_pdb();
+}
+
+shared_ptr<PDBCollection> compute_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns) {
+    int num_patterns = patterns.size();
+    shared_ptr<PDBCollection> pdbs = make_shared<PDBCollection>(num_patterns);
+    if (utils::is_persistent_cache_enabled()) {
+        // Compute the fingerprint before the jobs look it up concurrently.
+        task_properties::get_task_fingerprint(task_proxy);
+    }
+    utils::run_preprocessing_jobs(
+        num_patterns,
+        [&](int i) {
+            (*pdbs)[i] = compute_cached_pdb(task_proxy, patterns[i]);
+        },
+        [&](int i) {
+            /*
+              The distances, the search queue and the PDB factory's
+              per-state data take a few integers per abstract state.
+            */
+            size_t num_states = 1;
+            for (int var : patterns[i])
+                num_states *= task_proxy.get_variables()[var].get_domain_size();
+            return 4 * sizeof(int) * num_states;
+        });
+    return pdbs;
+}
+
 tuple<shared_ptr<PatternDatabase>, vector<vector<OperatorID>>>
 compute_pdb_and_plan(
     const TaskProxy &task_proxy,
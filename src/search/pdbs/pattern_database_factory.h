@@ -29,6 +29,28 @@ extern std::shared_ptr<PatternDatabase> compute_pdb(
     const std::vector<int> &operator_costs = std::vector<int>(),
     const std::shared_ptr<utils::RandomNumberGenerator> &rng = nullptr);
 
+/*
+  Like compute_pdb(), but reuse the distance table from the persistent
+  preprocessing cache (see utils/persistent_cache.h) if it is enabled, and
+  store newly computed tables there. Only use this for PDBs that end up in
+  the final heuristic: intermediate PDBs, e.g., the candidates evaluated by
+  pattern generators, would fill the cache with entries that are rarely
+  read again.
+*/
+extern std::shared_ptr<PatternDatabase> compute_cached_pdb(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const std::vector<int> &operator_costs = std::vector<int>());
+
+/*
+  Compute the PDBs for all patterns of the collection (with the original
+  operator costs) with compute_cached_pdb(). The PDBs are computed on up to
+  utils::get_preprocessing_threads() threads, within the preprocessing
+  memory budget. The result does not depend on the number of threads.
+*/
+extern std::shared_ptr<PDBCollection> compute_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns);
+
 /*
   In addition to computing a PDB for the given task and pattern like
   compute_pdb() above, also compute an abstract plan along.
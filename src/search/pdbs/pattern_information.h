@@ -42,6 +42,9 @@ public:
     }
 
     const Pattern &get_pattern() const;
+    bool has_pdb() const {
+        return pdb != nullptr;
+    }
     std::shared_ptr<PatternDatabase> get_pdb();
 };
 }
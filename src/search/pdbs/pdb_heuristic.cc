@@ -1,6 +1,7 @@
 #include "pdb_heuristic.h"
 
 #include "pattern_database.h"
+#include "pattern_database_factory.h"
 
 #include "../plugins/plugin.h"
 #include "../utils/markup.h"
@@ -15,15 +16,27 @@ static shared_ptr<PatternDatabase> get_pdb_from_generator(
     const shared_ptr<AbstractTask> &task,
     const shared_ptr<PatternGenerator> &pattern_generator) {
     PatternInformation pattern_info = pattern_generator->generate(task);
+    if (!pattern_info.has_pdb()) {
+        pattern_info.set_pdb(compute_cached_pdb(
+                                 pattern_info.get_task_proxy(),
+                                 pattern_info.get_pattern()));
+    }
     return pattern_info.get_pdb();
 }
 
 PDBHeuristic::PDBHeuristic(
-    const shared_ptr<PatternGenerator> &pattern,
+    const shared_ptr<PatternGenerator> &pattern, int max_table_kb,
     const shared_ptr<AbstractTask> &transform, bool cache_estimates,
     const string &description, utils::Verbosity verbosity)
     : Heuristic(transform, cache_estimates, description, verbosity),
       pdb(get_pdb_from_generator(task, pattern)) {
+    if (max_table_kb != numeric_limits<int>::max()) {
+        pdb->compress(static_cast<size_t>(max_table_kb) * 1024);
+    }
+    if (log.is_at_least_normal()) {
+        log << "PDB distance table: " << pdb->get_memory_usage()
+            << " bytes" << endl;
+    }
 }
 
 int PDBHeuristic::compute_heuristic(const State &ancestor_state) {
@@ -70,6 +83,14 @@ public:
             "pattern",
             "pattern generation method",
             "greedy()");
+        add_option<int>(
+            "max_table_kb",
+            "maximum memory of the distance table in KiB. Larger tables are "
+            "compressed by merging adjacent abstract states into their "
+            "minimum distance, which keeps the heuristic admissible but may "
+            "make it inconsistent.",
+            "infinity",
+            plugins::Bounds("1", "infinity"));
         add_heuristic_options_to_feature(*this, "pdb");
 
         document_language_support("action costs", "supported");
@@ -77,7 +98,7 @@ public:
         document_language_support("axioms", "not supported");
 
         document_property("admissible", "yes");
-        document_property("consistent", "yes");
+        document_property("consistent", "yes, unless the table is compressed");
         document_property("safe", "yes");
         document_property("preferred operators", "no");
     }
@@ -87,6 +108,7 @@ public:
         const utils::Context &) const override {
         return plugins::make_shared_from_arg_tuples<PDBHeuristic>(
             opts.get<shared_ptr<PatternGenerator>>("pattern"),
+            opts.get<int>("max_table_kb"),
             get_heuristic_arguments_from_options(opts)
             );
     }
@@ -23,9 +23,12 @@ public:
        operator_costs: Can specify individual operator costs for each
        operator. This is useful for action cost partitioning. If left
        empty, default operator costs are used.
+       max_table_kb: If the distance table needs more memory, it is
+       min-compressed until it fits.
     */
     PDBHeuristic(
         const std::shared_ptr<PatternGenerator> &pattern_generator,
+        int max_table_kb,
         const std::shared_ptr<AbstractTask> &transform,
         bool cache_estimates, const std::string &description,
         utils::Verbosity verbosity);
@@ -0,0 +1,59 @@
+#include "pdb_lookup.h"
+
+#include "pattern_database.h"
+
+#include <cassert>
+#include <limits>
+
+using namespace std;
+
+namespace pdbs {
+PDBLookup::PDBLookup(const PDBCollection &pdbs) {
+    distance_tables.reserve(pdbs.size());
+    first_entry.reserve(pdbs.size() + 1);
+    first_entry.push_back(0);
+    for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+        distance_tables.push_back(&pdb->get_distance_table());
+        const Projection &projection = pdb->get_projection();
+        const Pattern &pattern = projection.get_pattern();
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            variables.push_back(pattern[i]);
+            multipliers.push_back(projection.get_multiplier(i));
+        }
+        first_entry.push_back(variables.size());
+    }
+}
+
+inline int PDBLookup::get_value(
+    int pdb_index, const vector<int> &state) const {
+    int rank = 0;
+    for (int i = first_entry[pdb_index]; i < first_entry[pdb_index + 1]; ++i)
+        rank += multipliers[i] * state[variables[i]];
+    return distance_tables[pdb_index]->get(rank);
+}
+
+bool PDBLookup::compute_values(
+    const vector<int> &state, vector<int> &values) const {
+    int num_pdbs = distance_tables.size();
+    values.resize(num_pdbs);
+    for (int i = 0; i < num_pdbs; ++i) {
+        int h = get_value(i, state);
+        if (h == numeric_limits<int>::max())
+            return false;
+        values[i] = h;
+    }
+    return true;
+}
+
+int PDBLookup::compute_sum(const vector<int> &state) const {
+    int num_pdbs = distance_tables.size();
+    int sum = 0;
+    for (int i = 0; i < num_pdbs; ++i) {
+        int h = get_value(i, state);
+        if (h == numeric_limits<int>::max())
+            return numeric_limits<int>::max();
+        sum += h;
+    }
+    return sum;
+}
+}
@@ -0,0 +1,42 @@
+#ifndef PDBS_PDB_LOOKUP_H
+#define PDBS_PDB_LOOKUP_H
+
+#include "types.h"
+
+#include <vector>
+
+namespace pdbs {
+class DistanceTable;
+
+/*
+  Looks up the values of all PDBs of a collection for a state in one
+  pass. The pattern variables and hash multipliers of all projections
+  are stored back to back in flat arrays, so the ranks are computed by
+  a single loop over these arrays, without going through the PDB
+  objects. The PDBs must outlive the lookup.
+*/
+class PDBLookup {
+    std::vector<const DistanceTable *> distance_tables;
+    // Entries [first_entry[i], first_entry[i + 1]) belong to PDB i.
+    std::vector<int> first_entry;
+    std::vector<int> variables;
+    std::vector<int> multipliers;
+
+    int get_value(int pdb_index, const std::vector<int> &state) const;
+public:
+    explicit PDBLookup(const PDBCollection &pdbs);
+
+    /*
+      Store the value of each PDB for the given unpacked state in
+      values and return true. Stop and return false as soon as a PDB
+      detects a dead end.
+    */
+    bool compute_values(
+        const std::vector<int> &state, std::vector<int> &values) const;
+
+    // Return the sum of all values or numeric_limits<int>::max().
+    int compute_sum(const std::vector<int> &state) const;
+};
+}
+
+#endif
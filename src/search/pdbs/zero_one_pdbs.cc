@@ -16,7 +16,7 @@
 using namespace std;
 
 namespace pdbs {
-ZeroOnePDBs::ZeroOnePDBs(
+static PDBCollection compute_zero_one_pdbs(
     const TaskProxy &task_proxy, const PatternCollection &patterns) {
     vector<int> remaining_operator_costs;
     OperatorsProxy operators = task_proxy.get_operators();
@@ -24,9 +24,10 @@ ZeroOnePDBs::ZeroOnePDBs(
     for (OperatorProxy op : operators)
         remaining_operator_costs.push_back(op.get_cost());
 
+    PDBCollection pattern_databases;
     pattern_databases.reserve(patterns.size());
     for (const Pattern &pattern : patterns) {
-        shared_ptr<PatternDatabase> pdb = compute_pdb(
+        shared_ptr<PatternDatabase> pdb = compute_cached_pdb(
             task_proxy, pattern, remaining_operator_costs);
 
         /* Set cost of relevant operators to 0 for further iterations
@@ -38,8 +39,14 @@ ZeroOnePDBs::ZeroOnePDBs(
 
         pattern_databases.push_back(pdb);
     }
+    return pattern_databases;
 }
 
+ZeroOnePDBs::ZeroOnePDBs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns)
+    : pattern_databases(compute_zero_one_pdbs(task_proxy, patterns)),
+      lookup(pattern_databases) {
+}
 
 int ZeroOnePDBs::get_value(const State &state) const {
     /*
@@ -47,14 +54,7 @@ int ZeroOnePDBs::get_value(const State &state) const {
       heuristic values of all patterns in the pattern collection.
     */
     state.unpack();
-    int h_val = 0;
-    for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
-        int pdb_value = pdb->get_value(state.get_unpacked_values());
-        if (pdb_value == numeric_limits<int>::max())
-            return numeric_limits<int>::max();
-        h_val += pdb_value;
-    }
-    return h_val;
+    return lookup.compute_sum(state.get_unpacked_values());
 }
 
 double ZeroOnePDBs::compute_approx_mean_finite_h() const {
@@ -51,12 +51,13 @@ public:
 
     Entry &operator[](const TaskProxy &task_proxy) {
         TaskID id = task_proxy.get_id();
-        const auto &it = entries.find(id);
+        auto it = entries.find(id);
         if (it == entries.end()) {
-            entries[id] = entry_constructor(task_proxy);
+            it = entries.emplace(id, entry_constructor(task_proxy)).first;
             task_proxy.subscribe_to_task_destruction(this);
         }
-        return *entries[id];
+        // Looking up an existing entry does not modify the map.
+        return *it->second;
     }
 
     virtual void notify_service_destroyed(const AbstractTask *task) override {
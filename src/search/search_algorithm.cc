@@ -39,6 +39,15 @@ static successor_generator::SuccessorGenerator &get_successor_generator(
     return successor_generator;
 }
 
+/*
+  Return true if the given cost type changes the cost of some operator. Only
+  in this case, the search space has to store real g values separately.
+*/
+static bool cost_type_changes_costs(
+    OperatorCost cost_type, const TaskProxy &task_proxy) {
+    return cost_type != NORMAL && !task_properties::is_unit_cost(task_proxy);
+}
+
 SearchAlgorithm::SearchAlgorithm(
     OperatorCost cost_type, int bound, double max_time,
     const string &description, utils::Verbosity verbosity)
@@ -50,7 +59,8 @@ SearchAlgorithm::SearchAlgorithm(
       log(utils::get_log_for_verbosity(verbosity)),
       state_registry(task_proxy),
       successor_generator(get_successor_generator(task_proxy, log)),
-      search_space(state_registry, log),
+      search_space(state_registry, log,
+                   cost_type_changes_costs(cost_type, task_proxy)),
       statistics(log),
       bound(bound),
       cost_type(cost_type),
@@ -73,7 +83,9 @@ SearchAlgorithm::SearchAlgorithm(const plugins::Options &opts) // TODO options o
               opts.get<utils::Verbosity>("verbosity"))),
       state_registry(task_proxy),
       successor_generator(get_successor_generator(task_proxy, log)),
-      search_space(state_registry, log),
+      search_space(state_registry, log,
+                   cost_type_changes_costs(
+                       opts.get<OperatorCost>("cost_type"), task_proxy)),
       statistics(log),
       cost_type(opts.get<OperatorCost>("cost_type")),
       is_unit_cost(task_properties::is_unit_cost(task_proxy)),
@@ -3,7 +3,7 @@
 #include "../evaluation_context.h"
 #include "../evaluator.h"
 #include "../open_list_factory.h"
-#include "../open_lists/div_tiebreaking_open_list.h"
+#include "../open_lists/plateau_statistics.h"
 #include "../pruning_method.h"
 
 #include "../algorithms/ordered_set.h"
@@ -26,7 +26,8 @@ EagerSearch::EagerSearch(
     const vector<shared_ptr<Evaluator>> &preferred,
     const bool use_depth,
     const shared_ptr<PruningMethod> &pruning,
-    const shared_ptr<Evaluator> &lazy_evaluator, OperatorCost cost_type,
+    const shared_ptr<Evaluator> &lazy_evaluator, bool batch_evaluation,
+    OperatorCost cost_type,
     int bound, double max_time, const string &description,
     utils::Verbosity verbosity)
     : SearchAlgorithm(
@@ -36,10 +37,8 @@ EagerSearch::EagerSearch(
       f_evaluator(f_eval),     // default nullptr
       preferred_operator_evaluators(preferred),
       use_depth(use_depth),
-      max_plateau_entries(0),
-      max_plateau_depth(0),
-      max_depth_width(0),
       lazy_evaluator(lazy_evaluator),     // default nullptr
+      batch_evaluation(batch_evaluation),
       pruning_method(pruning) {
     if (lazy_evaluator && !lazy_evaluator->does_cache_estimates()) {
         cerr << "lazy_evaluator must cache its estimates" << endl;
@@ -84,6 +83,12 @@ void EagerSearch::initialize() {
 
     path_dependent_evaluators.assign(evals.begin(), evals.end());
 
+    if (batch_evaluation) {
+        set<Evaluator *> open_list_evals;
+        open_list->get_evaluators(open_list_evals);
+        batch_evaluators.assign(open_list_evals.begin(), open_list_evals.end());
+    }
+
     State initial_state = state_registry.get_initial_state();
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
@@ -122,9 +127,12 @@ void EagerSearch::initialize() {
 }
 
 void EagerSearch::print_statistics() const {
-    cout << "Max plateau entries : " << max_plateau_entries << endl;
-    cout << "Max plateau depth : " << max_plateau_depth << endl;
-    cout << "Max depth width : " << max_depth_width << endl;
+    PlateauStatistics plateau_statistics;
+    if (use_depth && open_list->get_plateau_statistics())
+        plateau_statistics = *open_list->get_plateau_statistics();
+    cout << "Max plateau entries : " << plateau_statistics.max_entries << endl;
+    cout << "Max plateau depth : " << plateau_statistics.max_depth << endl;
+    cout << "Max depth width : " << plateau_statistics.max_depth_width << endl;
     statistics.print_detailed_statistics();
     search_space.print_statistics();
     pruning_method->print_statistics();
@@ -132,6 +140,12 @@ void EagerSearch::print_statistics() const {
 
 SearchStatus EagerSearch::step() {
     optional<SearchNode> node;
+    /*
+      The evaluation context of the expanded node is kept for all of its
+      successors, so that values computed for it (in particular its
+      f-value, needed by depth-diversified open lists) are cached.
+    */
+    optional<EvaluationContext> node_eval_context;
     while (true) {
         if (open_list->empty()) {
             log << "Completely explored state space -- no solution!" << endl;
@@ -148,7 +162,8 @@ SearchStatus EagerSearch::step() {
           We can pass calculate_preferred=false here since preferred
           operators are computed when the state is expanded.
         */
-        EvaluationContext eval_context(s, node->get_g(), false, &statistics);
+        node_eval_context.emplace(s, node->get_g(), false, &statistics);
+        EvaluationContext &eval_context = *node_eval_context;
 
         if (lazy_evaluator) {
             /*
@@ -206,6 +221,9 @@ SearchStatus EagerSearch::step() {
 
     // This evaluates the expanded state (again) to get preferred ops
     EvaluationContext eval_context(s, node->get_g(), false, &statistics, true);
+    int d_value = use_depth ? node->get_d() : 0; // depth_value for depth-diversification strategy
+    node_eval_context->set_d_value(d_value);
+
     ordered_set::OrderedSet<OperatorID> preferred_operators;
     for (const shared_ptr<Evaluator> &preferred_operator_evaluator : preferred_operator_evaluators) {
         collect_preferred_operators(eval_context,
@@ -213,6 +231,13 @@ SearchStatus EagerSearch::step() {
                                     preferred_operators);
     }
 
+    if (batch_evaluation) {
+        generate_successors_batched(
+            *node, applicable_ops, preferred_operators, *node_eval_context,
+            d_value);
+        return IN_PROGRESS;
+    }
+
     for (OperatorID op_id : applicable_ops) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
         if ((node->get_real_g() + op.get_cost()) >= bound)
@@ -224,10 +249,6 @@ SearchStatus EagerSearch::step() {
 
         SearchNode succ_node = search_space.get_node(succ_state);
 
-        EvaluationContext curr_eval_context(s, node->get_g(), is_preferred, &statistics);
-        int d_value = node->get_d(); // depth_value for depth-diversification strategy
-        curr_eval_context.set_d_value(d_value);
-
         for (Evaluator *evaluator : path_dependent_evaluators) {
             evaluator->notify_state_transition(s, op_id, succ_state);
         }
@@ -257,22 +278,8 @@ SearchStatus EagerSearch::step() {
                 continue;
             }
             succ_node.open_new_node(*node, op, get_adjusted_cost(op));
-            if (use_depth) {
-                vector<int> max_search_values = open_list->insert(succ_eval_context, succ_state.get_id(), curr_eval_context, d_value);
-                if (max_search_values[0] > max_plateau_entries) {
-                    max_plateau_entries = max_search_values[0];
-                }
-                if (max_search_values[1] > max_plateau_depth) {
-                    max_plateau_depth = max_search_values[1];
-                }
-                if (max_search_values[2] > max_depth_width) {
-                    max_depth_width = max_search_values[2];
-                }
-                int new_d = succ_eval_context.get_d_value();
-                succ_node.set_d(new_d);
-            } else {
-                open_list->insert(succ_eval_context, succ_state.get_id());
-            }
+            insert_into_open_list(
+                succ_eval_context, succ_node, *node_eval_context, d_value);
 
             if (search_progress.check_progress(succ_eval_context)) {
                 statistics.print_checkpoint_line(succ_node.get_g());
@@ -285,22 +292,8 @@ SearchStatus EagerSearch::step() {
                     *node, op, get_adjusted_cost(op));
                 EvaluationContext succ_eval_context(
                     succ_state, succ_node.get_g(), is_preferred, &statistics);
-                if (use_depth) {
-                    vector<int> max_search_values = open_list->insert(succ_eval_context, succ_state.get_id(), curr_eval_context, d_value);
-                    if (max_search_values[0] > max_plateau_entries) {
-                        max_plateau_entries = max_search_values[0];
-                    }
-                    if (max_search_values[1] > max_plateau_depth) {
-                        max_plateau_depth = max_search_values[1];
-                    }
-                    if (max_search_values[2] > max_depth_width) {
-                        max_depth_width = max_search_values[2];
-                    }
-                    int new_d = succ_eval_context.get_d_value();
-                    succ_node.set_d(new_d);
-                } else {
-                    open_list->insert(succ_eval_context, succ_state.get_id());
-                }
+                insert_into_open_list(
+                    succ_eval_context, succ_node, *node_eval_context, d_value);
             } else if (succ_node.is_closed() && reopen_closed_nodes) {
                 /*
                   TODO: It would be nice if we had a way to test
@@ -313,22 +306,8 @@ SearchStatus EagerSearch::step() {
                 succ_node.reopen_closed_node(*node, op, get_adjusted_cost(op));
                 EvaluationContext succ_eval_context(
                     succ_state, succ_node.get_g(), is_preferred, &statistics);
-                if (use_depth) {
-                    vector<int> max_search_values = open_list->insert(succ_eval_context, succ_state.get_id(), curr_eval_context, d_value);
-                    if (max_search_values[0] > max_plateau_entries) {
-                        max_plateau_entries = max_search_values[0];
-                    }
-                    if (max_search_values[1] > max_plateau_depth) {
-                        max_plateau_depth = max_search_values[1];
-                    }
-                    if (max_search_values[2] > max_depth_width) {
-                        max_depth_width = max_search_values[2];
-                    }
-                    int new_d = succ_eval_context.get_d_value();
-                    succ_node.set_d(new_d);
-                } else {
-                    open_list->insert(succ_eval_context, succ_state.get_id());
-                }
+                insert_into_open_list(
+                    succ_eval_context, succ_node, *node_eval_context, d_value);
             } else {
                 /*
                   If we do not reopen closed nodes, we just update the parent
@@ -350,6 +329,134 @@ SearchStatus EagerSearch::step() {
     return IN_PROGRESS;
 }
 
+void EagerSearch::insert_into_open_list(
+    EvaluationContext &succ_eval_context, SearchNode &succ_node,
+    EvaluationContext &parent_eval_context, int parent_d) {
+    StateID succ_id = succ_node.get_state().get_id();
+    if (use_depth) {
+        open_list->insert(succ_eval_context, succ_id, parent_eval_context, parent_d);
+        succ_node.set_d(succ_eval_context.get_d_value());
+    } else {
+        open_list->insert(succ_eval_context, succ_id);
+    }
+}
+
+void EagerSearch::generate_successors_batched(
+    const SearchNode &node, const vector<OperatorID> &applicable_ops,
+    const ordered_set::OrderedSet<OperatorID> &preferred_operators,
+    EvaluationContext &node_eval_context, int d_value) {
+    /*
+      We first register all successors and update the search space, then
+      evaluate all successors that have to be (re-)inserted into the open
+      list in one batch, and finally insert them.
+    */
+    struct PendingSuccessor {
+        State state;
+        int g;
+        bool is_preferred;
+        bool is_new;
+    };
+
+    const State &s = node.get_state();
+    vector<PendingSuccessor> pending_successors;
+    pending_successors.reserve(applicable_ops.size());
+    /*
+      A state can be reached on a cheaper path after it has become
+      pending in this batch. Then we update its entry instead of adding
+      a second one, so that it is only evaluated once. This only happens
+      for cheaper paths, so a linear scan suffices.
+    */
+    auto add_or_update_pending = [&](const State &succ_state, int succ_g,
+                                     bool is_preferred) {
+            for (PendingSuccessor &pending : pending_successors) {
+                if (pending.state.get_id() == succ_state.get_id()) {
+                    pending.g = succ_g;
+                    pending.is_preferred = pending.is_preferred || is_preferred;
+                    return;
+                }
+            }
+            pending_successors.push_back({succ_state, succ_g, is_preferred, false});
+        };
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if ((node.get_real_g() + op.get_cost()) >= bound)
+            continue;
+
+        State succ_state = state_registry.get_successor_state(s, op);
+        statistics.inc_generated();
+        bool is_preferred = preferred_operators.contains(op_id);
+
+        SearchNode succ_node = search_space.get_node(succ_state);
+
+        for (Evaluator *evaluator : path_dependent_evaluators) {
+            evaluator->notify_state_transition(s, op_id, succ_state);
+        }
+
+        // Previously encountered dead end. Don't re-evaluate.
+        if (succ_node.is_dead_end())
+            continue;
+
+        int adjusted_cost = get_adjusted_cost(op);
+        int succ_g = node.get_g() + adjusted_cost;
+        if (succ_node.is_new()) {
+            /*
+              We open the node before knowing whether it is a dead end, so
+              that further paths to it within this batch are treated like
+              paths to an open node. If it turns out to be a dead end, we
+              mark it as such after the batch evaluation.
+            */
+            succ_node.open_new_node(node, op, adjusted_cost);
+            statistics.inc_evaluated_states();
+            pending_successors.push_back({succ_state, succ_g, is_preferred, true});
+        } else if (succ_node.get_g() > succ_g) {
+            // We found a new cheapest path to an open or closed state.
+            if (succ_node.is_open()) {
+                succ_node.update_open_node_parent(node, op, adjusted_cost);
+                add_or_update_pending(succ_state, succ_g, is_preferred);
+            } else if (succ_node.is_closed() && reopen_closed_nodes) {
+                statistics.inc_reopened();
+                succ_node.reopen_closed_node(node, op, adjusted_cost);
+                add_or_update_pending(succ_state, succ_g, is_preferred);
+            } else {
+                assert(succ_node.is_closed() && !reopen_closed_nodes);
+                succ_node.update_closed_node_parent(node, op, adjusted_cost);
+            }
+        }
+    }
+
+    vector<EvaluationContext> succ_eval_contexts;
+    succ_eval_contexts.reserve(pending_successors.size());
+    vector<EvaluationContext *> batch;
+    batch.reserve(pending_successors.size());
+    for (const PendingSuccessor &pending : pending_successors) {
+        succ_eval_contexts.emplace_back(
+            pending.state, pending.g, pending.is_preferred, &statistics);
+        batch.push_back(&succ_eval_contexts.back());
+    }
+    for (Evaluator *evaluator : batch_evaluators) {
+        evaluator->compute_batch_results(batch);
+    }
+
+    for (size_t i = 0; i < pending_successors.size(); ++i) {
+        const PendingSuccessor &pending = pending_successors[i];
+        EvaluationContext &succ_eval_context = succ_eval_contexts[i];
+        SearchNode succ_node = search_space.get_node(pending.state);
+        if (succ_node.is_dead_end())
+            continue;
+        if (pending.is_new && open_list->is_dead_end(succ_eval_context)) {
+            succ_node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+            continue;
+        }
+        insert_into_open_list(
+            succ_eval_context, succ_node, node_eval_context, d_value);
+        if (pending.is_new && search_progress.check_progress(succ_eval_context)) {
+            statistics.print_checkpoint_line(succ_node.get_g());
+            reward_progress();
+        }
+    }
+}
+
 void EagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
@@ -379,18 +486,25 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
 void add_eager_search_options_to_feature(
     plugins::Feature &feature, const string &description) {
     add_search_pruning_options_to_feature(feature);
+    feature.add_option<bool>(
+        "batch_evaluation",
+        "register all successors of an expanded state first and evaluate "
+        "the ones that enter the open list in one batch. Evaluators that "
+        "support batch evaluation can then share work between the successors.",
+        "false");
     // We do not add a lazy_evaluator options here
     // because it is only used for astar but not the other plugins.
     add_search_algorithm_options_to_feature(feature, description);
 }
 
-tuple<shared_ptr<PruningMethod>, shared_ptr<Evaluator>, OperatorCost,
+tuple<shared_ptr<PruningMethod>, shared_ptr<Evaluator>, bool, OperatorCost,
       int, double, string, utils::Verbosity>
 get_eager_search_arguments_from_options(const plugins::Options &opts) {
     return tuple_cat(
         get_search_pruning_arguments_from_options(opts),
         make_tuple(opts.get<shared_ptr<Evaluator>>(
-                       "lazy_evaluator", nullptr)),
+                       "lazy_evaluator", nullptr),
+                   opts.get<bool>("batch_evaluation")),
         get_search_algorithm_arguments_from_options(opts)
         );
 }
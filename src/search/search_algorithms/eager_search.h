@@ -4,6 +4,8 @@
 #include "../open_list.h"
 #include "../search_algorithm.h"
 
+#include "../algorithms/ordered_set.h"
+
 #include <memory>
 #include <vector>
 
@@ -25,17 +27,23 @@ class EagerSearch : public SearchAlgorithm {
     std::vector<Evaluator *> path_dependent_evaluators;
     std::vector<std::shared_ptr<Evaluator>> preferred_operator_evaluators;
     bool use_depth;
-    int max_plateau_entries;
-    int max_plateau_depth;
-    int max_depth_width;
-    int max_number_of_plateaus;
     std::shared_ptr<Evaluator> lazy_evaluator;
+    bool batch_evaluation;
+    // Evaluators of the open list, only collected with batch_evaluation.
+    std::vector<Evaluator *> batch_evaluators;
 
     std::shared_ptr<PruningMethod> pruning_method;
 
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
+    void insert_into_open_list(
+        EvaluationContext &succ_eval_context, SearchNode &succ_node,
+        EvaluationContext &parent_eval_context, int parent_d);
+    void generate_successors_batched(
+        const SearchNode &node, const std::vector<OperatorID> &applicable_ops,
+        const ordered_set::OrderedSet<OperatorID> &preferred_operators,
+        EvaluationContext &node_eval_context, int d_value);
 
 protected:
     virtual void initialize() override;
@@ -49,7 +57,7 @@ public:
         const bool use_depth,
         const std::shared_ptr<PruningMethod> &pruning,
         const std::shared_ptr<Evaluator> &lazy_evaluator,
-        OperatorCost cost_type, int bound, double max_time,
+        bool batch_evaluation, OperatorCost cost_type, int bound, double max_time,
         const std::string &description, utils::Verbosity verbosity);
 
     virtual void print_statistics() const override;
@@ -60,8 +68,8 @@ public:
 extern void add_eager_search_options_to_feature(
     plugins::Feature &feature, const std::string &description);
 extern std::tuple<std::shared_ptr<PruningMethod>,
-                  std::shared_ptr<Evaluator>, OperatorCost, int, double,
-                  std::string, utils::Verbosity>
+                  std::shared_ptr<Evaluator>, bool, OperatorCost, int,
+                  double, std::string, utils::Verbosity>
 get_eager_search_arguments_from_options(const plugins::Options &opts);
 }
 
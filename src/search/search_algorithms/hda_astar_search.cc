@@ -0,0 +1,559 @@
+#include "hda_astar_search.h"
+
+#include "../concurrent_state_registry.h"
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+
+#include "../algorithms/int_packer.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace hda_astar_search {
+/*
+  Parents are identified by their ID in the shared state registry, so a
+  plan can be traced back across workers.
+*/
+struct ParentInfo {
+    StateID state_id;
+    OperatorID creating_operator;
+
+    ParentInfo()
+        : state_id(StateID::no_state),
+          creating_operator(OperatorID::no_operator) {
+    }
+
+    ParentInfo(StateID state_id, OperatorID creating_operator)
+        : state_id(state_id),
+          creating_operator(creating_operator) {
+    }
+};
+
+struct Message {
+    Message *next;
+    StateID state_id;
+    int g;
+    int real_g;
+    ParentInfo parent;
+
+    Message(StateID state_id, int g, int real_g, const ParentInfo &parent)
+        : next(nullptr), state_id(state_id), g(g), real_g(real_g),
+          parent(parent) {
+    }
+};
+
+/*
+  Lock-free multiple-producer single-consumer queue. Producers push onto
+  an intrusive stack with compare-and-swap, the consumer takes all
+  messages at once. Messages are therefore consumed in LIFO order, which
+  does not matter for HDA* since they are sorted into the open list.
+*/
+class MessageQueue {
+    atomic<Message *> head;
+public:
+    MessageQueue()
+        : head(nullptr) {
+    }
+
+    ~MessageQueue() {
+        Message *message = pop_all();
+        while (message) {
+            Message *next = message->next;
+            delete message;
+            message = next;
+        }
+    }
+
+    void push(Message *message) {
+        Message *old_head = head.load(memory_order_relaxed);
+        do {
+            message->next = old_head;
+        } while (!head.compare_exchange_weak(
+                     old_head, message,
+                     memory_order_release, memory_order_relaxed));
+    }
+
+    Message *pop_all() {
+        return head.exchange(nullptr, memory_order_acquire);
+    }
+
+    bool empty() const {
+        return head.load(memory_order_acquire) == nullptr;
+    }
+};
+
+struct OpenListEntry {
+    int f;
+    int h;
+    int g;
+    StateID state_id;
+
+    OpenListEntry(int f, int h, int g, StateID state_id)
+        : f(f), h(h), g(g), state_id(state_id) {
+    }
+
+    // Order for a max-heap that pops minimal f values, breaking ties by h.
+    bool operator<(const OpenListEntry &other) const {
+        if (f != other.f)
+            return f > other.f;
+        return h > other.h;
+    }
+};
+
+struct NodeInfo {
+    enum class Status : char {
+        NEW, OPEN, CLOSED, DEAD_END
+    };
+
+    Status status;
+    int g;
+    int real_g;
+    // Heuristic values are stored here, since the states are not
+    // registered in a StateRegistry and can't be cached by evaluators.
+    int h;
+    ParentInfo parent;
+
+    NodeInfo()
+        : status(Status::NEW), g(-1), real_g(-1), h(-1) {
+    }
+};
+
+struct Worker {
+    HDAStarSearch &search;
+    const ConcurrentStateRegistry &registry;
+    const int id;
+
+    utils::LogProxy log;
+    SearchStatistics statistics;
+    shared_ptr<Evaluator> evaluator;
+
+    // nodes[shard][index in shard], only used for the shards of this worker.
+    vector<vector<NodeInfo>> nodes;
+    priority_queue<OpenListEntry> open_list;
+    MessageQueue inbox;
+
+    vector<OperatorID> applicable_ops;
+    vector<PackedStateBin> successor_buffer;
+
+    Worker(HDAStarSearch &search, int id,
+           const shared_ptr<Evaluator> &evaluator)
+        : search(search),
+          registry(*search.registry),
+          id(id),
+          log(utils::get_silent_log()),
+          statistics(log),
+          evaluator(evaluator),
+          nodes(registry.get_num_shards()),
+          successor_buffer(registry.get_num_bins()) {
+    }
+
+    // The reference is invalidated by the next call.
+    NodeInfo &get_node(StateID state_id);
+    void receive(StateID state_id, int g, int real_g,
+                 const ParentInfo &parent);
+    void process_inbox();
+    void send(int owner, StateID state_id, int g, int real_g,
+              const ParentInfo &parent);
+    bool expand_next();
+    void run();
+};
+
+NodeInfo &Worker::get_node(StateID state_id) {
+    assert(search.get_owner(state_id) == id);
+    vector<NodeInfo> &shard_nodes = nodes[registry.get_shard(state_id)];
+    int index = registry.get_index_in_shard(state_id);
+    if (index >= static_cast<int>(shard_nodes.size()))
+        shard_nodes.resize(index + 1);
+    return shard_nodes[index];
+}
+
+void Worker::receive(StateID state_id, int g, int real_g,
+                     const ParentInfo &parent) {
+    NodeInfo &node = get_node(state_id);
+    if (node.status == NodeInfo::Status::DEAD_END ||
+        (node.status != NodeInfo::Status::NEW && node.g <= g))
+        return;
+
+    if (node.status == NodeInfo::Status::NEW) {
+        EvaluationContext eval_context(
+            search.unpack_state(state_id), g, false, &statistics);
+        statistics.inc_evaluated_states();
+        if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+            statistics.inc_dead_ends();
+            node.status = NodeInfo::Status::DEAD_END;
+            return;
+        }
+        node.h = eval_context.get_evaluator_value(evaluator.get());
+    } else if (node.status == NodeInfo::Status::CLOSED) {
+        statistics.inc_reopened();
+    }
+
+    node.status = NodeInfo::Status::OPEN;
+    node.g = g;
+    node.real_g = real_g;
+    node.parent = parent;
+    if (g + node.h < search.incumbent_cost.load(memory_order_relaxed))
+        open_list.emplace(g + node.h, node.h, g, state_id);
+}
+
+void Worker::process_inbox() {
+    Message *message = inbox.pop_all();
+    long long num_messages = 0;
+    while (message) {
+        receive(message->state_id, message->g, message->real_g,
+                message->parent);
+        Message *next = message->next;
+        delete message;
+        message = next;
+        ++num_messages;
+    }
+    if (num_messages)
+        search.outstanding_work -= num_messages;
+}
+
+void Worker::send(int owner, StateID state_id, int g, int real_g,
+                  const ParentInfo &parent) {
+    // Count the message before it becomes visible to the receiver.
+    ++search.outstanding_work;
+    search.workers[owner]->inbox.push(
+        new Message(state_id, g, real_g, parent));
+}
+
+bool Worker::expand_next() {
+    while (!open_list.empty()) {
+        OpenListEntry entry = open_list.top();
+        if (entry.f >= search.incumbent_cost.load(memory_order_relaxed)) {
+            // No remaining entry can lead to a cheaper plan.
+            open_list = priority_queue<OpenListEntry>();
+            return false;
+        }
+        open_list.pop();
+
+        NodeInfo &node = get_node(entry.state_id);
+        if (node.status != NodeInfo::Status::OPEN || node.g != entry.g)
+            continue;
+        node.status = NodeInfo::Status::CLOSED;
+        int real_g = node.real_g;
+
+        State state = search.unpack_state(entry.state_id);
+        if (task_properties::is_goal_state(search.task_proxy, state)) {
+            search.update_incumbent(entry.state_id, entry.g);
+            return true;
+        }
+        statistics.inc_expanded();
+
+        applicable_ops.clear();
+        search.successor_generator.generate_applicable_ops(
+            state, applicable_ops);
+        statistics.inc_generated_ops(applicable_ops.size());
+
+        const int_packer::IntPacker &state_packer =
+            registry.get_state_packer();
+        const PackedStateBin *buffer = registry.lookup_buffer(entry.state_id);
+        OperatorsProxy operators = search.task_proxy.get_operators();
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = operators[op_id];
+            int succ_real_g = real_g + op.get_cost();
+            if (succ_real_g >= search.bound)
+                continue;
+            int succ_g = entry.g + search.get_adjusted_cost(op);
+            if (succ_g >= search.incumbent_cost.load(memory_order_relaxed))
+                continue;
+
+            copy_n(buffer, successor_buffer.size(), successor_buffer.begin());
+            for (EffectProxy effect : op.get_effects()) {
+                if (does_fire(effect, state)) {
+                    FactPair effect_pair = effect.get_fact().get_pair();
+                    state_packer.set(successor_buffer.data(),
+                                     effect_pair.var, effect_pair.value);
+                }
+            }
+            statistics.inc_generated();
+
+            /*
+              Registering the successor here, rather than at its owner,
+              keeps the messages small.
+            */
+            StateID succ_id = search.registry->insert(
+                successor_buffer.data()).first;
+            ParentInfo parent(entry.state_id, op_id);
+            int owner = search.get_owner(succ_id);
+            if (owner == id) {
+                receive(succ_id, succ_g, succ_real_g, parent);
+            } else {
+                send(owner, succ_id, succ_g, succ_real_g, parent);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+void Worker::run() {
+    while (!search.terminate.load()) {
+        process_inbox();
+        if (!expand_next()) {
+            // Become idle until new messages arrive or the search ends.
+            --search.outstanding_work;
+            while (true) {
+                if (search.terminate.load())
+                    return;
+                if (!inbox.empty()) {
+                    ++search.outstanding_work;
+                    break;
+                }
+                if (search.outstanding_work.load() == 0) {
+                    search.terminate = true;
+                    return;
+                }
+                this_thread::yield();
+            }
+        }
+    }
+}
+
+
+HDAStarSearch::HDAStarSearch(
+    const parser::LazyValue &evaluator_config, int num_threads,
+    OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(
+          cost_type, bound, max_time, description, verbosity),
+      evaluator_config(evaluator_config),
+      num_threads(num_threads),
+      /*
+        Workers own the shards whose index maps to them. Using several
+        shards per worker keeps the load balanced if the number of threads
+        is not a power of two.
+      */
+      registry(utils::make_unique_ptr<ConcurrentStateRegistry>(
+                   task_proxy, 8 * num_threads)),
+      incumbent_cost(numeric_limits<int>::max()),
+      incumbent_state(StateID::no_state),
+      outstanding_work(0),
+      terminate(false) {
+}
+
+HDAStarSearch::~HDAStarSearch() {
+}
+
+int HDAStarSearch::get_owner(StateID id) const {
+    return registry->get_shard(id) % num_threads;
+}
+
+State HDAStarSearch::unpack_state(StateID id) const {
+    const PackedStateBin *buffer = registry->lookup_buffer(id);
+    const int_packer::IntPacker &state_packer = registry->get_state_packer();
+    int num_variables = task_proxy.get_variables().size();
+    vector<int> values(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        values[var] = state_packer.get(buffer, var);
+    }
+    return task_proxy.create_state(move(values));
+}
+
+void HDAStarSearch::update_incumbent(StateID goal_state_id, int g) {
+    lock_guard<mutex> lock(incumbent_mutex);
+    if (g < incumbent_cost.load()) {
+        incumbent_cost = g;
+        incumbent_state = goal_state_id;
+        log << "New incumbent with cost " << g
+            << " found by worker " << get_owner(goal_state_id) << endl;
+    }
+}
+
+void HDAStarSearch::trace_incumbent_path(Plan &plan) const {
+    assert(plan.empty());
+    StateID state_id = incumbent_state;
+    while (true) {
+        Worker &worker = *workers[get_owner(state_id)];
+        const ParentInfo &parent = worker.get_node(state_id).parent;
+        if (parent.state_id == StateID::no_state) {
+            assert(parent.creating_operator == OperatorID::no_operator);
+            break;
+        }
+        plan.push_back(parent.creating_operator);
+        state_id = parent.state_id;
+    }
+    reverse(plan.begin(), plan.end());
+}
+
+void HDAStarSearch::initialize() {
+    log << "Conducting hash-distributed A* search with " << num_threads
+        << " threads, (real) bound = " << bound << endl;
+    task_properties::verify_no_axioms(task_proxy);
+
+    workers.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        shared_ptr<Evaluator> evaluator;
+        try {
+            evaluator = evaluator_config.construct<shared_ptr<Evaluator>>();
+        } catch (const utils::ContextError &e) {
+            cerr << "Delayed construction of LazyValue failed" << endl;
+            cerr << e.get_message() << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        for (const unique_ptr<Worker> &worker : workers) {
+            if (worker->evaluator == evaluator) {
+                cerr << "hda_astar needs one evaluator instance per thread. "
+                     << "Define the evaluator inline instead of using let."
+                     << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+            }
+        }
+        set<Evaluator *> path_dependent_evaluators;
+        evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+        if (!path_dependent_evaluators.empty()) {
+            cerr << "hda_astar does not support path-dependent evaluators."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+        workers.push_back(utils::make_unique_ptr<Worker>(*this, i, evaluator));
+    }
+
+    const State &initial_state = state_registry.get_initial_state();
+    StateID initial_state_id =
+        registry->insert(initial_state.get_buffer()).first;
+    Worker &owner = *workers[get_owner(initial_state_id)];
+    owner.receive(initial_state_id, 0, 0, ParentInfo());
+    if (owner.open_list.empty())
+        log << "Initial state is a dead end." << endl;
+    else
+        log << "Initial heuristic value: " << owner.open_list.top().h << endl;
+    outstanding_work = num_threads;
+}
+
+SearchStatus HDAStarSearch::step() {
+    // The workers run in parallel, so we measure wall-clock time.
+    utils::CountdownTimer timer(max_time, true);
+    vector<thread> threads;
+    threads.reserve(num_threads);
+    for (const unique_ptr<Worker> &worker : workers) {
+        threads.emplace_back(&Worker::run, worker.get());
+    }
+
+    bool timeout = false;
+    while (!terminate.load()) {
+        if (timer.is_expired()) {
+            timeout = true;
+            terminate = true;
+            break;
+        }
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    for (thread &worker_thread : threads) {
+        worker_thread.join();
+    }
+
+    for (const unique_ptr<Worker> &worker : workers) {
+        const SearchStatistics &worker_statistics = worker->statistics;
+        statistics.inc_expanded(worker_statistics.get_expanded());
+        statistics.inc_evaluated_states(
+            worker_statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker_statistics.get_evaluations());
+        statistics.inc_generated(worker_statistics.get_generated());
+        statistics.inc_reopened(worker_statistics.get_reopened());
+        statistics.inc_generated_ops(worker_statistics.get_generated_ops());
+        statistics.inc_dead_ends(worker_statistics.get_dead_ends());
+    }
+
+    if (timeout)
+        return TIMEOUT;
+    if (incumbent_state == StateID::no_state) {
+        log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    log << "Solution found!" << endl;
+    Plan plan;
+    trace_incumbent_path(plan);
+    set_plan(plan);
+    return SOLVED;
+}
+
+void HDAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    if (log.is_at_least_verbose()) {
+        for (const unique_ptr<Worker> &worker : workers) {
+            log << "Worker " << worker->id << ": "
+                << worker->statistics.get_expanded() << " expanded" << endl;
+        }
+    }
+    registry->print_statistics(log);
+}
+
+class HDAStarSearchFeature
+    : public plugins::TypedFeature<SearchAlgorithm, HDAStarSearch> {
+public:
+    HDAStarSearchFeature() : TypedFeature("hda_astar") {
+        document_title("Hash-distributed A* search");
+        document_synopsis(
+            "Parallel A* search in which each worker thread owns the states "
+            "whose hash maps to it and has its own open list and evaluator "
+            "instance. All workers share a concurrent state registry. "
+            "Generated states are sent to their owners. See\n\n"
+            " * Akihiro Kishimoto, Alex Fukunaga and Adi Botea.<<BR>>\n"
+            " [Scalable, Parallel Best-First Search for Optimal Sequential "
+            "Planning "
+            "https://ojs.aaai.org/index.php/ICAPS/article/view/13350].<<BR>>\n "
+            "In //Proceedings of the Nineteenth International Conference on "
+            "Automated Planning and Scheduling (ICAPS 2009)//, "
+            "pp. 201-208. AAAI Press, 2009.");
+
+        add_option<shared_ptr<Evaluator>>(
+            "eval",
+            "evaluator for h-value. It is constructed once per thread.",
+            "",
+            plugins::Bounds::unlimited(),
+            true);
+        add_option<int>(
+            "threads",
+            "number of worker threads",
+            "4",
+            plugins::Bounds("1", "infinity"));
+        add_search_algorithm_options_to_feature(*this, "hda_astar");
+
+        document_note(
+            "Evaluator instances",
+            "Each thread needs its own evaluator instance, so the evaluator "
+            "must be defined inline. Sharing an evaluator (or one of its "
+            "components) between threads with let is not supported.");
+        document_note(
+            "Time limit",
+            "Unlike other search algorithms, hda_astar measures max_time in "
+            "wall-clock time, since its workers run in parallel.");
+        document_note(
+            "Evaluator caches",
+            "The states of hda_astar are not registered in a regular state "
+            "registry, so evaluators do not cache their estimates and "
+            "path-dependent evaluators are not supported.");
+        document_language_support("axioms", "not supported");
+        document_property("optimal", "yes if the evaluator is admissible");
+    }
+
+    virtual shared_ptr<HDAStarSearch> create_component(
+        const plugins::Options &opts,
+        const utils::Context &) const override {
+        return plugins::make_shared_from_arg_tuples<HDAStarSearch>(
+            opts.get<parser::LazyValue>("eval"),
+            opts.get<int>("threads"),
+            get_search_algorithm_arguments_from_options(opts)
+            );
+    }
+};
+
+static plugins::FeaturePlugin<HDAStarSearchFeature> _plugin;
+}
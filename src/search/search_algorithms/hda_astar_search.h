@@ -0,0 +1,77 @@
+#ifndef SEARCH_ALGORITHMS_HDA_ASTAR_SEARCH_H
+#define SEARCH_ALGORITHMS_HDA_ASTAR_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include "../parser/decorated_abstract_syntax_tree.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ConcurrentStateRegistry;
+class Evaluator;
+
+namespace hda_astar_search {
+struct Worker;
+
+/*
+  Hash-distributed A* (HDA*): every worker thread owns the states whose
+  hash maps to it. All workers share one ConcurrentStateRegistry, and
+  each worker owns the registry shards whose index maps to it. A worker
+  keeps the search nodes of its shards, its own open list and heuristic
+  instance, and expands its own states. It registers the states it
+  generates itself and sends their IDs to their owners. Workers
+  communicate only through lock-free message queues.
+
+  The search terminates when no worker has open nodes that can improve
+  on the incumbent and no messages are in flight. With an admissible
+  heuristic, the incumbent is then optimal.
+*/
+class HDAStarSearch : public SearchAlgorithm {
+    friend struct Worker;
+
+    parser::LazyValue evaluator_config;
+    const int num_threads;
+
+    std::unique_ptr<ConcurrentStateRegistry> registry;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /*
+      Adjusted cost of the best plan found so far (or infinity if none was
+      found). The bound is checked separately on real costs.
+    */
+    std::atomic<int> incumbent_cost;
+    std::mutex incumbent_mutex;
+    StateID incumbent_state;
+
+    /*
+      Number of busy workers plus number of messages in flight. The search
+      space is exhausted once this drops to zero.
+    */
+    std::atomic<long long> outstanding_work;
+    std::atomic<bool> terminate;
+
+    int get_owner(StateID id) const;
+    // Returns an unregistered state with the data of the registered state.
+    State unpack_state(StateID id) const;
+    void update_incumbent(StateID goal_state_id, int g);
+    void trace_incumbent_path(Plan &plan) const;
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    HDAStarSearch(
+        const parser::LazyValue &evaluator_config, int num_threads,
+        OperatorCost cost_type, int bound, double max_time,
+        const std::string &description, utils::Verbosity verbosity);
+    virtual ~HDAStarSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -7,19 +7,23 @@
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
+/*
+  Real g values and depth values are not part of SearchNodeInfo: real g
+  values only differ from g values under cost transformations and depth
+  values are only used by depth-diversified search. SearchSpace stores
+  them in separate per-state tables when they are needed.
+*/
 struct SearchNodeInfo {
     enum NodeStatus {NEW = 0, OPEN = 1, CLOSED = 2, DEAD_END = 3};
 
     unsigned int status : 2;
     int g : 30;
-    int d;
     StateID parent_state_id;
     OperatorID creating_operator;
-    int real_g;
 
-    SearchNodeInfo() // initialiserlist (kurzform von konstruktor) mit -1 als default
-        : status(NEW), g(-1), d(0), parent_state_id(StateID::no_state),
-          creating_operator(-1), real_g(-1) {
+    SearchNodeInfo()
+        : status(NEW), g(-1), parent_state_id(StateID::no_state),
+          creating_operator(-1) {
     }
 };
 
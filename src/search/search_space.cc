@@ -10,8 +10,10 @@
 
 using namespace std;
 
-SearchNode::SearchNode(const State &state, SearchNodeInfo &info)
-    : state(state), info(info) {
+SearchNode::SearchNode(const State &state, SearchNodeInfo &info,
+                       PerStateInformation<int> *real_g_values,
+                       PerStateInformation<int> &depths)
+    : state(state), info(info), real_g_values(real_g_values), depths(depths) {
     assert(state.get_id() != StateID::no_state);
 }
 
@@ -41,25 +43,28 @@ int SearchNode::get_g() const {
 }
 
 int SearchNode::get_d() const {
-    assert(info.d >= 0);
-    return info.d;
+    int d = depths[state];
+    assert(d >= 0);
+    return d;
 }
 
 void SearchNode::set_d(int d_val) const {
     assert(d_val >= 0);
-    info.d = d_val;
+    depths[state] = d_val;
 }
 
 int SearchNode::get_real_g() const {
-    return info.real_g;
+    if (real_g_values)
+        return (*real_g_values)[state];
+    return info.g;
 }
 
 void SearchNode::open_initial() {
     assert(info.status == SearchNodeInfo::NEW);
     info.status = SearchNodeInfo::OPEN;
     info.g = 0;
-    info.d = 0;
-    info.real_g = 0;
+    if (real_g_values)
+        (*real_g_values)[state] = 0;
     info.parent_state_id = StateID::no_state;
     info.creating_operator = OperatorID::no_operator;
 }
@@ -68,7 +73,8 @@ void SearchNode::update_parent(const SearchNode &parent_node,
                                const OperatorProxy &parent_op,
                                int adjusted_cost) {
     info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
+    if (real_g_values)
+        (*real_g_values)[state] = parent_node.get_real_g() + parent_op.get_cost();
     info.parent_state_id = parent_node.get_state().get_id();
     info.creating_operator = OperatorID(parent_op.get_id());
 }
@@ -127,12 +133,19 @@ void SearchNode::dump(const TaskProxy &task_proxy, utils::LogProxy &log) const {
     }
 }
 
-SearchSpace::SearchSpace(StateRegistry &state_registry, utils::LogProxy &log)
-    : state_registry(state_registry), log(log) {
+SearchSpace::SearchSpace(StateRegistry &state_registry, utils::LogProxy &log,
+                         bool store_real_g_values)
+    : store_real_g_values(store_real_g_values),
+      real_g_values(-1),
+      depths(0),
+      state_registry(state_registry),
+      log(log) {
 }
 
 SearchNode SearchSpace::get_node(const State &state) {
-    return SearchNode(state, search_node_infos[state]);
+    return SearchNode(
+        state, search_node_infos[state],
+        store_real_g_values ? &real_g_values : nullptr, depths);
 }
 
 void SearchSpace::trace_path(const State &goal_state,
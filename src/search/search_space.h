@@ -18,12 +18,18 @@ class LogProxy;
 class SearchNode {
     State state;
     SearchNodeInfo &info;
+    // nullptr if real g values coincide with g values and are not stored.
+    PerStateInformation<int> *real_g_values;
+    // Only accessed, and hence only allocated, by depth-diversified search.
+    PerStateInformation<int> &depths;
 
     void update_parent(const SearchNode &parent_node,
                        const OperatorProxy &parent_op,
                        int adjusted_cost);
 public:
-    SearchNode(const State &state, SearchNodeInfo &info);
+    SearchNode(const State &state, SearchNodeInfo &info,
+               PerStateInformation<int> *real_g_values,
+               PerStateInformation<int> &depths);
 
     const State &get_state() const;
 
@@ -59,11 +65,19 @@ public:
 
 class SearchSpace {
     PerStateInformation<SearchNodeInfo> search_node_infos;
+    /*
+      Real g values are only stored if the cost type changes some
+      operator cost. Otherwise, they coincide with the g values.
+    */
+    bool store_real_g_values;
+    PerStateInformation<int> real_g_values;
+    PerStateInformation<int> depths;
 
     StateRegistry &state_registry;
     utils::LogProxy &log;
 public:
-    SearchSpace(StateRegistry &state_registry, utils::LogProxy &log);
+    SearchSpace(StateRegistry &state_registry, utils::LogProxy &log,
+                bool store_real_g_values);
 
     SearchNode get_node(const State &state);
     void trace_path(const State &goal_state,
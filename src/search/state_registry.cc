@@ -13,7 +13,10 @@ StateRegistry::StateRegistry(const TaskProxy &task_proxy)
       state_packer(task_properties::g_state_packers[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
       num_variables(task_proxy.get_variables().size()),
-      state_data_pool(get_bins_per_state()),
+      external_memory_arena(utils::create_external_memory_arena()),
+      state_data_pool(
+          get_bins_per_state(),
+          utils::ExternalMemoryAllocator<PackedStateBin>(external_memory_arena)),
       registered_states(
           StateIDSemanticHash(state_data_pool, get_bins_per_state()),
           StateIDSemanticEqual(state_data_pool, get_bins_per_state())) {
@@ -126,4 +129,11 @@ int StateRegistry::get_state_size_in_bytes() const {
 void StateRegistry::print_statistics(utils::LogProxy &log) const {
     log << "Number of registered states: " << size() << endl;
     registered_states.print_statistics(log);
+    if (external_memory_arena) {
+        log << "External memory file size: "
+            << external_memory_arena->get_file_size() / 1024 << " KB" << endl;
+        log << "External memory spilled: "
+            << external_memory_arena->get_num_spilled_bytes() / 1024
+            << " KB" << endl;
+    }
 }
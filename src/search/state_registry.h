@@ -9,6 +9,7 @@
 #include "algorithms/int_packer.h"
 #include "algorithms/segmented_vector.h"
 #include "algorithms/subscriber.h"
+#include "utils/external_memory.h"
 #include "utils/hash.h"
 
 #include <set>
@@ -113,11 +114,18 @@ using PackedStateBin = int_packer::IntPacker::Bin;
 
 
 class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
+    /*
+      State data lives on the heap, or in external memory if this is
+      enabled on the command line (see utils/external_memory.h).
+    */
+    using StateDataPool = segmented_vector::SegmentedArrayVector<
+        PackedStateBin, utils::ExternalMemoryAllocator<PackedStateBin>>;
+
     struct StateIDSemanticHash {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateDataPool &state_data_pool;
         int state_size;
         StateIDSemanticHash(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
+            const StateDataPool &state_data_pool,
             int state_size)
             : state_data_pool(state_data_pool),
               state_size(state_size) {
@@ -134,10 +142,10 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     };
 
     struct StateIDSemanticEqual {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateDataPool &state_data_pool;
         int state_size;
         StateIDSemanticEqual(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
+            const StateDataPool &state_data_pool,
             int state_size)
             : state_data_pool(state_data_pool),
               state_size(state_size) {
@@ -162,7 +170,8 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     AxiomEvaluator &axiom_evaluator;
     const int num_variables;
 
-    segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    std::shared_ptr<utils::ExternalMemoryArena> external_memory_arena;
+    StateDataPool state_data_pool;
     StateIDSet registered_states;
 
     std::unique_ptr<State> cached_initial_state;
@@ -184,6 +193,16 @@ public:
         return state_packer;
     }
 
+    /*
+      Returns the arena that stores the data of this registry in external
+      memory, or nullptr if data is stored on the heap. Per-state
+      information for this registry uses the same arena.
+    */
+    const std::shared_ptr<utils::ExternalMemoryArena> &
+    get_external_memory_arena() const {
+        return external_memory_arena;
+    }
+
     /*
       Returns the state that was registered at the given ID. The ID must refer
       to a state in this registry. Do not mix IDs from from different registries.
@@ -1,5 +1,6 @@
 #include "task_properties.h"
 
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
 #include "../utils/system.h"
@@ -178,4 +179,43 @@ PerTaskInformation<int_packer::IntPacker> g_state_packers(
         return utils::make_unique_ptr<int_packer::IntPacker>(variable_ranges);
     }
     );
+
+static void feed_operator(utils::HashState &hash_state, const OperatorProxy &op) {
+    utils::feed(hash_state, get_fact_pairs(op.get_preconditions()));
+    EffectsProxy effects = op.get_effects();
+    utils::feed(hash_state, static_cast<int>(effects.size()));
+    for (EffectProxy effect : effects) {
+        utils::feed(hash_state, get_fact_pairs(effect.get_conditions()));
+        utils::feed(hash_state, effect.get_fact().get_pair());
+    }
+    utils::feed(hash_state, op.get_cost());
+}
+
+static PerTaskInformation<uint64_t> task_fingerprints(
+    [](const TaskProxy &task_proxy) {
+        utils::HashState hash_state;
+        VariablesProxy variables = task_proxy.get_variables();
+        utils::feed(hash_state, static_cast<int>(variables.size()));
+        for (VariableProxy var : variables) {
+            utils::feed(hash_state, var.get_domain_size());
+            utils::feed(hash_state, var.get_axiom_layer());
+            utils::feed(hash_state, var.get_default_axiom_value());
+        }
+        OperatorsProxy operators = task_proxy.get_operators();
+        utils::feed(hash_state, static_cast<int>(operators.size()));
+        for (OperatorProxy op : operators)
+            feed_operator(hash_state, op);
+        AxiomsProxy axioms = task_proxy.get_axioms();
+        utils::feed(hash_state, static_cast<int>(axioms.size()));
+        for (OperatorProxy axiom : axioms)
+            feed_operator(hash_state, axiom);
+        utils::feed(hash_state, task_proxy.get_initial_state().get_unpacked_values());
+        utils::feed(hash_state, get_fact_pairs(task_proxy.get_goals()));
+        return utils::make_unique_ptr<uint64_t>(hash_state.get_hash64());
+    }
+    );
+
+uint64_t get_task_fingerprint(const TaskProxy &task_proxy) {
+    return task_fingerprints[task_proxy];
+}
 }
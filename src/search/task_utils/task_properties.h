@@ -82,6 +82,13 @@ extern void dump_fdr(const State &state);
 extern void dump_goals(const GoalsProxy &goals);
 extern void dump_task(const TaskProxy &task_proxy);
 
+/*
+  Return a hash of the complete task (variables, operators, axioms, initial
+  state and goals). It is computed once per task and can be used to
+  identify the task across planner runs, e.g., for utils::persistent_cache.
+*/
+extern uint64_t get_task_fingerprint(const TaskProxy &task_proxy);
+
 extern PerTaskInformation<int_packer::IntPacker> g_state_packers;
 }
 
@@ -5,8 +5,9 @@
 using namespace std;
 
 namespace utils {
-CountdownTimer::CountdownTimer(double max_time)
-    : max_time(max_time) {
+CountdownTimer::CountdownTimer(double max_time, bool wall_clock)
+    : timer(true, wall_clock),
+      max_time(max_time) {
 }
 
 CountdownTimer::~CountdownTimer() {
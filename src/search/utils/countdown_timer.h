@@ -8,7 +8,8 @@ class CountdownTimer {
     Timer timer;
     double max_time;
 public:
-    explicit CountdownTimer(double max_time);
+    // See Timer for the meaning of wall_clock.
+    explicit CountdownTimer(double max_time, bool wall_clock = false);
     ~CountdownTimer();
     bool is_expired() const;
     Duration get_elapsed_time() const;
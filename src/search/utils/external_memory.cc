@@ -0,0 +1,175 @@
+#include "external_memory.h"
+
+#include "logging.h"
+#include "system.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+// Memory is mapped in chunks of this size (unless allocations are larger).
+static const size_t CHUNK_BYTES = 64 * 1024 * 1024;
+
+static string external_memory_directory;
+static size_t external_memory_resident_bytes = 0;
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+NO_RETURN
+static void exit_with_system_error(const string &msg, ExitCode exitcode) {
+    cerr << "External memory: " << msg << ": " << strerror(errno) << endl;
+    utils::exit_with(exitcode);
+}
+
+ExternalMemoryArena::ExternalMemoryArena(
+    const string &directory, size_t resident_bytes)
+    : directory(directory),
+      resident_bytes(resident_bytes),
+      page_size(sysconf(_SC_PAGESIZE)),
+      file_descriptor(-1),
+      file_size(0),
+      chunk_position(nullptr),
+      chunk_remaining(0),
+      num_resident_bytes(0),
+      num_spilled_bytes(0) {
+    string path_template = directory + "/downward-external-memory-XXXXXX";
+    vector<char> path(path_template.begin(), path_template.end());
+    path.push_back('\0');
+    file_descriptor = mkstemp(path.data());
+    if (file_descriptor == -1) {
+        exit_with_system_error(
+            "could not create file in " + directory,
+            ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    // The file stays accessible through the descriptor until it is closed.
+    unlink(path.data());
+}
+
+ExternalMemoryArena::~ExternalMemoryArena() {
+    for (const auto &mapping : mappings) {
+        munmap(mapping.first, mapping.second);
+    }
+    close(file_descriptor);
+}
+
+char *ExternalMemoryArena::map_file_range(size_t size) {
+    if (ftruncate(file_descriptor, file_size + size) == -1) {
+        exit_with_system_error(
+            "could not grow file in " + directory,
+            ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         file_descriptor, file_size);
+    if (address == MAP_FAILED) {
+        exit_with_system_error(
+            "could not map file", ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    file_size += size;
+    mappings.emplace_back(static_cast<char *>(address), size);
+    return static_cast<char *>(address);
+}
+
+void ExternalMemoryArena::release_cold_allocations() {
+    while (num_resident_bytes > resident_bytes &&
+           resident_allocations.size() > 1) {
+        char *address = resident_allocations.front().first;
+        size_t size = resident_allocations.front().second;
+        resident_allocations.pop_front();
+        /*
+          Dropping the pages of a shared file mapping keeps their content
+          in the page cache or the file, from where it is read back when
+          the memory is accessed again.
+        */
+        msync(address, size, MS_ASYNC);
+        madvise(address, size, MADV_DONTNEED);
+        num_resident_bytes -= size;
+        num_spilled_bytes += size;
+    }
+}
+
+void *ExternalMemoryArena::allocate(size_t size) {
+    size = (size + page_size - 1) / page_size * page_size;
+    char *address;
+    if (size > CHUNK_BYTES) {
+        address = map_file_range(size);
+    } else {
+        if (size > chunk_remaining) {
+            chunk_position = map_file_range(CHUNK_BYTES);
+            chunk_remaining = CHUNK_BYTES;
+        }
+        address = chunk_position;
+        chunk_position += size;
+        chunk_remaining -= size;
+    }
+    resident_allocations.emplace_back(address, size);
+    num_resident_bytes += size;
+    release_cold_allocations();
+    return address;
+}
+#else
+ExternalMemoryArena::ExternalMemoryArena(
+    const string &directory, size_t resident_bytes)
+    : directory(directory),
+      resident_bytes(resident_bytes),
+      page_size(0),
+      file_descriptor(-1),
+      file_size(0),
+      chunk_position(nullptr),
+      chunk_remaining(0),
+      num_resident_bytes(0),
+      num_spilled_bytes(0) {
+    cerr << "External memory is not supported on this operating system."
+         << endl;
+    utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+}
+
+ExternalMemoryArena::~ExternalMemoryArena() {
+}
+
+char *ExternalMemoryArena::map_file_range(size_t) {
+    return nullptr;
+}
+
+void ExternalMemoryArena::release_cold_allocations() {
+}
+
+void *ExternalMemoryArena::allocate(size_t) {
+    return nullptr;
+}
+#endif
+
+void enable_external_memory(
+    const string &directory, int resident_memory_in_mb) {
+    external_memory_directory = directory;
+    external_memory_resident_bytes =
+        static_cast<size_t>(resident_memory_in_mb) * 1024 * 1024;
+    g_log << "Storing per-state data in " << directory << ", keeping "
+          << resident_memory_in_mb << " MB resident" << endl;
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    rlimit address_space_limit;
+    if (getrlimit(RLIMIT_AS, &address_space_limit) == 0 &&
+        address_space_limit.rlim_cur != RLIM_INFINITY) {
+        g_log << "Warning: the address space is limited, and the external "
+              << "memory counts towards this limit. Limit the data segment "
+              << "(RLIMIT_DATA) instead." << endl;
+    }
+#endif
+}
+
+shared_ptr<ExternalMemoryArena> create_external_memory_arena() {
+    if (external_memory_directory.empty())
+        return nullptr;
+    return make_shared<ExternalMemoryArena>(
+        external_memory_directory, external_memory_resident_bytes);
+}
+}
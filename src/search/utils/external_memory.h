@@ -0,0 +1,128 @@
+#ifndef UTILS_EXTERNAL_MEMORY_H
+#define UTILS_EXTERNAL_MEMORY_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utils {
+/*
+  ExternalMemoryArena hands out memory backed by a file in a scratch
+  directory. The file is mapped into memory in large chunks, so the
+  operating system can write pages to disk and read them back on demand.
+
+  Only the most recently allocated memory (up to resident_bytes) is kept
+  resident. Older allocations are written back and dropped from memory
+  when new memory is allocated, and are paged in again when accessed.
+  This suits append-only data such as the state data pool, where recently
+  generated states are accessed most often.
+
+  Memory is only released when the arena is destroyed. The backing file
+  is deleted right after its creation, so it disappears when the planner
+  exits, even if it crashes.
+
+  Note that mapped files count towards address space limits (RLIMIT_AS),
+  but not towards data segment limits (RLIMIT_DATA), since the file is
+  mapped as shared memory. With --external-memory, the driver therefore
+  limits the memory of the search with RLIMIT_DATA.
+*/
+class ExternalMemoryArena {
+    const std::string directory;
+    const std::size_t resident_bytes;
+    const std::size_t page_size;
+    int file_descriptor;
+    std::size_t file_size;
+
+    std::vector<std::pair<char *, std::size_t>> mappings;
+    char *chunk_position;
+    std::size_t chunk_remaining;
+
+    std::deque<std::pair<char *, std::size_t>> resident_allocations;
+    std::size_t num_resident_bytes;
+    std::size_t num_spilled_bytes;
+
+    char *map_file_range(std::size_t size);
+    void release_cold_allocations();
+public:
+    ExternalMemoryArena(const std::string &directory, std::size_t resident_bytes);
+    ~ExternalMemoryArena();
+
+    ExternalMemoryArena(const ExternalMemoryArena &) = delete;
+    ExternalMemoryArena &operator=(const ExternalMemoryArena &) = delete;
+
+    // Returned memory is aligned to the page size.
+    void *allocate(std::size_t size);
+
+    std::size_t get_file_size() const {
+        return file_size;
+    }
+
+    std::size_t get_num_spilled_bytes() const {
+        return num_spilled_bytes;
+    }
+};
+
+/*
+  Allocator for containers such as segmented_vector::SegmentedVector that
+  takes its memory from an ExternalMemoryArena, or from the heap if it
+  has no arena.
+*/
+template<typename T>
+class ExternalMemoryAllocator {
+    std::shared_ptr<ExternalMemoryArena> arena;
+public:
+    using value_type = T;
+
+    ExternalMemoryAllocator() = default;
+
+    explicit ExternalMemoryAllocator(
+        const std::shared_ptr<ExternalMemoryArena> &arena)
+        : arena(arena) {
+    }
+
+    template<typename U>
+    ExternalMemoryAllocator(const ExternalMemoryAllocator<U> &other)
+        : arena(other.get_arena()) {
+    }
+
+    const std::shared_ptr<ExternalMemoryArena> &get_arena() const {
+        return arena;
+    }
+
+    T *allocate(std::size_t n) {
+        if (arena)
+            return static_cast<T *>(arena->allocate(n * sizeof(T)));
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *ptr, std::size_t n) {
+        // Arena memory is released together with the arena.
+        if (!arena)
+            std::allocator<T>().deallocate(ptr, n);
+    }
+
+    template<typename U>
+    bool operator==(const ExternalMemoryAllocator<U> &other) const {
+        return arena == other.get_arena();
+    }
+
+    template<typename U>
+    bool operator!=(const ExternalMemoryAllocator<U> &other) const {
+        return !(*this == other);
+    }
+};
+
+/*
+  Global setting for storing per-state data in external memory, set from
+  the command line. Without a call to enable_external_memory,
+  create_external_memory_arena returns nullptr.
+*/
+extern void enable_external_memory(
+    const std::string &directory, int resident_memory_in_mb);
+extern std::shared_ptr<ExternalMemoryArena> create_external_memory_arena();
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "parallel.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+static int num_preprocessing_threads = 1;
+static size_t preprocessing_memory_budget = 2048ULL * 1024 * 1024;
+
+void set_preprocessing_threads(int num_threads) {
+    assert(num_threads >= 1);
+    num_preprocessing_threads = num_threads;
+}
+
+int get_preprocessing_threads() {
+    return num_preprocessing_threads;
+}
+
+void set_preprocessing_memory_budget(size_t num_bytes) {
+    preprocessing_memory_budget = num_bytes;
+}
+
+void run_preprocessing_jobs(
+    int num_jobs, const function<void(int)> &job,
+    const function<size_t(int)> &estimate_memory) {
+    int num_threads = min(num_preprocessing_threads, num_jobs);
+    if (num_threads <= 1) {
+        for (int i = 0; i < num_jobs; ++i)
+            job(i);
+        return;
+    }
+
+    mutex jobs_mutex;
+    condition_variable job_finished;
+    int next_job = 0;
+    int num_running_jobs = 0;
+    size_t running_memory = 0;
+    exception_ptr first_exception;
+
+    auto can_start_next_job = [&]() {
+            return next_job == num_jobs || num_running_jobs == 0 ||
+                   running_memory + estimate_memory(next_job) <=
+                   preprocessing_memory_budget;
+        };
+    auto worker = [&]() {
+            unique_lock<mutex> lock(jobs_mutex);
+            while (true) {
+                job_finished.wait(lock, can_start_next_job);
+                if (next_job == num_jobs)
+                    return;
+                int job_id = next_job++;
+                size_t memory = estimate_memory(job_id);
+                ++num_running_jobs;
+                running_memory += memory;
+                lock.unlock();
+                exception_ptr exception;
+                try {
+                    job(job_id);
+                } catch (...) {
+                    exception = current_exception();
+                }
+                lock.lock();
+                if (exception && !first_exception) {
+                    // Let the running jobs finish, but start no new ones.
+                    first_exception = exception;
+                    next_job = num_jobs;
+                }
+                --num_running_jobs;
+                running_memory -= memory;
+                job_finished.notify_all();
+            }
+        };
+
+    vector<thread> threads;
+    threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i)
+        threads.emplace_back(worker);
+    for (thread &t : threads)
+        t.join();
+    if (first_exception)
+        rethrow_exception(first_exception);
+}
+}
@@ -0,0 +1,41 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace utils {
+/*
+  Settings for running independent preprocessing steps, such as the
+  construction of the pattern databases of a collection, on several
+  threads. By default, preprocessing uses a single thread.
+
+  The memory budget limits the memory that the jobs running at the
+  same time may use together, according to the estimates passed to
+  run_preprocessing_jobs. It does not limit the memory of the results.
+*/
+extern void set_preprocessing_threads(int num_threads);
+extern int get_preprocessing_threads();
+extern void set_preprocessing_memory_budget(std::size_t num_bytes);
+
+/*
+  Run job(0), ..., job(num_jobs - 1), using up to
+  get_preprocessing_threads() threads. Jobs are started in the order of
+  their indices. A job is started only if its estimated memory fits
+  into the budget next to the running jobs, or if no other job is
+  running.
+
+  Jobs must only write to data that belongs to their index, so that
+  the results do not depend on the number of threads. With a single
+  thread, the jobs run in order on the calling thread.
+
+  If a job throws an exception (e.g., an ExitException from exit_with),
+  no further jobs are started. After the running jobs have finished, the
+  first exception is rethrown on the calling thread.
+*/
+extern void run_preprocessing_jobs(
+    int num_jobs, const std::function<void(int)> &job,
+    const std::function<std::size_t(int)> &estimate_memory);
+}
+
+#endif
@@ -0,0 +1,83 @@
+#include "persistent_cache.h"
+
+#include "logging.h"
+#include "system.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+namespace utils {
+static const uint64_t CACHE_FILE_MAGIC = 0x3165686361436466; // "fdCache1"
+
+static string persistent_cache_directory;
+static atomic<bool> did_write_store_warning(false);
+
+void enable_persistent_cache(const string &directory) {
+    persistent_cache_directory = directory;
+    g_log << "Caching preprocessing results in " << directory << endl;
+}
+
+bool is_persistent_cache_enabled() {
+    return !persistent_cache_directory.empty();
+}
+
+static string get_cache_file_name(const string &kind, uint64_t key) {
+    ostringstream name;
+    name << persistent_cache_directory << "/" << kind << "-"
+         << hex << setw(16) << setfill('0') << key << ".bin";
+    return name.str();
+}
+
+bool load_from_persistent_cache(
+    const string &kind, uint64_t key, vector<int> &data) {
+    if (!is_persistent_cache_enabled())
+        return false;
+    ifstream file(get_cache_file_name(kind, key), ios::binary);
+    if (!file)
+        return false;
+    uint64_t header[3];
+    if (!file.read(reinterpret_cast<char *>(header), sizeof(header)) ||
+        header[0] != CACHE_FILE_MAGIC || header[1] != key) {
+        return false;
+    }
+    data.resize(header[2]);
+    if (!file.read(reinterpret_cast<char *>(data.data()),
+                   data.size() * sizeof(int))) {
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+void store_in_persistent_cache(
+    const string &kind, uint64_t key, const vector<int> &data) {
+    if (!is_persistent_cache_enabled())
+        return;
+    string file_name = get_cache_file_name(kind, key);
+    string tmp_file_name =
+        file_name + ".tmp" + to_string(get_process_id());
+    {
+        ofstream file(tmp_file_name, ios::binary);
+        uint64_t header[3] = {CACHE_FILE_MAGIC, key, data.size()};
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(data.data()),
+                   data.size() * sizeof(int));
+        if (!file) {
+            file.close();
+            remove(tmp_file_name.c_str());
+            if (!did_write_store_warning.exchange(true)) {
+                g_log << "WARNING: could not write to the cache in "
+                      << persistent_cache_directory << endl;
+            }
+            return;
+        }
+    }
+    if (rename(tmp_file_name.c_str(), file_name.c_str()) != 0)
+        remove(tmp_file_name.c_str());
+}
+}
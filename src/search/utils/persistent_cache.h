@@ -0,0 +1,35 @@
+#ifndef UTILS_PERSISTENT_CACHE_H
+#define UTILS_PERSISTENT_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace utils {
+/*
+  Opt-in cache for the results of expensive preprocessing steps, such as
+  the distance tables of pattern databases, that are shared between
+  planner runs on the same task.
+
+  Entries are files in the cache directory, named after their kind (for
+  example "pdb") and a 64-bit key. Callers must compute the key from
+  everything the data depends on, usually a fingerprint of the task
+  (see task_properties::get_task_fingerprint) and the parameters of the
+  computation.
+
+  Files are written to a temporary name and then renamed, so concurrent
+  planner runs sharing a directory never read partially written entries.
+  Without a call to enable_persistent_cache, nothing is read or written.
+*/
+extern void enable_persistent_cache(const std::string &directory);
+extern bool is_persistent_cache_enabled();
+
+// Return true and fill data iff the cache contains an entry for the key.
+extern bool load_from_persistent_cache(
+    const std::string &kind, std::uint64_t key, std::vector<int> &data);
+// Failing to write an entry is reported, but not treated as an error.
+extern void store_in_persistent_cache(
+    const std::string &kind, std::uint64_t key, const std::vector<int> &data);
+}
+
+#endif
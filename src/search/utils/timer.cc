@@ -53,7 +53,8 @@ void mach_absolute_difference(uint64_t end, uint64_t start, struct timespec *tp)
 #endif
 
 
-Timer::Timer(bool start) {
+Timer::Timer(bool start, bool wall_clock)
+    : wall_clock(wall_clock) {
 #if OPERATING_SYSTEM == WINDOWS
     QueryPerformanceFrequency(&frequency);
     QueryPerformanceCounter(&start_ticks);
@@ -76,7 +77,8 @@ double Timer::current_clock() const {
     uint64_t end = mach_absolute_time();
     mach_absolute_difference(end, start, &tp);
 #else
-    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &tp);
+    clock_gettime(
+        wall_clock ? CLOCK_MONOTONIC : CLOCK_PROCESS_CPUTIME_ID, &tp);
 #endif
     return tp.tv_sec + tp.tv_nsec / 1e9;
 #endif
@@ -17,10 +17,18 @@ public:
 
 std::ostream &operator<<(std::ostream &os, const Duration &time);
 
+/*
+  Timers measure the CPU time of the process on Linux, so that time
+  limits match the planner's CPU time limits. Searches and preprocessing
+  steps that run on several threads can measure wall-clock time instead,
+  since otherwise their time limits would run out once per thread.
+  (On Windows and macOS, timers always measure wall-clock time.)
+*/
 class Timer {
     double last_start_clock;
     double collected_time;
     bool stopped;
+    bool wall_clock;
 #if OPERATING_SYSTEM == WINDOWS
     LARGE_INTEGER frequency;
     LARGE_INTEGER start_ticks;
@@ -28,7 +36,7 @@ class Timer {
 
     double current_clock() const;
 public:
-    explicit Timer(bool start = true);
+    explicit Timer(bool start = true, bool wall_clock = false);
     ~Timer() = default;
     Duration operator()() const;
     Duration stop();